@@ -0,0 +1,199 @@
+/*
+ * Benchmark of the plib_grid2d storage layouts: row-major vs. tiled.
+ *
+ * Generates a random grid of size x size cells (default 4096) and times
+ * vertical and diagonal access patterns like those of day 4 (words down and
+ * diagonal) and day 6 (walking along columns), plus a row sweep as reference.
+ * All cells are accessed through plib_grid2d_at in both layouts.
+ *
+ * Usage: program [size] [seed]
+ *
+ * (C) Copyright 2024 "piscilus" Julian Kraemer
+ *
+ * Distributed under MIT license.
+ * See file LICENSE for details or copy at https://opensource.org/licenses/MIT
+ */
+
+#define PLIB_GRID2D_IMPLEMENTATION
+#define PLIB_GRID2D_NO_NAMESPACE
+#include "plib_grid2d.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RUNS (5U)
+
+static const char word[] = "XMAS";
+
+static double
+now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+/* Words down, down-right and down-left (day 4) */
+static size_t
+words_vertical_diagonal(const grid2d_t* g)
+{
+    const size_t n = sizeof(word) - 1U;
+    size_t count = 0U;
+
+    for (size_t y = 0U; y + n <= g->max_y; y++)
+    {
+        for (size_t x = 0U; x < g->max_x; x++)
+        {
+            if (*grid2d_at(g, y, x) != word[0])
+                continue;
+            size_t i;
+            for (i = 1U; (i < n) && (*grid2d_at(g, y + i, x) == word[i]); i++)
+                ;
+            count += (i == n);
+            if (x + n <= g->max_x)
+            {
+                for (i = 1U; (i < n) && (*grid2d_at(g, y + i, x + i) == word[i]); i++)
+                    ;
+                count += (i == n);
+            }
+            if (x + 1U >= n)
+            {
+                for (i = 1U; (i < n) && (*grid2d_at(g, y + i, x - i) == word[i]); i++)
+                    ;
+                count += (i == n);
+            }
+        }
+    }
+
+    return count;
+}
+
+/* Walk down every column (day 6 guard moving up/down) */
+static size_t
+columns(const grid2d_t* g)
+{
+    size_t count = 0U;
+
+    for (size_t x = 0U; x < g->max_x; x++)
+        for (size_t y = 0U; y < g->max_y; y++)
+            count += (*grid2d_at(g, y, x) == word[0]);
+
+    return count;
+}
+
+/* Walk along every row, the access pattern row-major storage is made for */
+static size_t
+rows(const grid2d_t* g)
+{
+    size_t count = 0U;
+
+    for (size_t y = 0U; y < g->max_y; y++)
+        for (size_t x = 0U; x < g->max_x; x++)
+            count += (*grid2d_at(g, y, x) == word[0]);
+
+    return count;
+}
+
+typedef struct
+{
+    const char* name;
+    size_t (*fn)(const grid2d_t* g);
+} kernel_t;
+
+/* Best time of RUNS in milliseconds */
+static double
+measure(const kernel_t* k, const grid2d_t* g, size_t* result)
+{
+    double best = 0.0;
+
+    for (size_t r = 0U; r < RUNS; r++)
+    {
+        double start = now();
+        *result = k->fn(g);
+        double t = (now() - start) * 1e3;
+        if ((r == 0U) || (t < best))
+            best = t;
+    }
+
+    return best;
+}
+
+int
+main(int argc, char** argv)
+{
+    size_t size = (argc > 1) ? strtoul(*(argv + 1), NULL, 10) : 4096U;
+    unsigned int seed = (argc > 2) ? (unsigned int)strtoul(*(argv + 2), NULL, 10) : 1U;
+    if (size == 0U)
+    {
+        fprintf(stderr, "Invalid size.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* lines of random letters of the word, the grids are built in place */
+    size_t buffer_size = size * (size + 1U);
+    char* buffers[2] = {malloc(buffer_size), malloc(buffer_size)};
+    if ((buffers[0] == NULL) || (buffers[1] == NULL))
+    {
+        fprintf(stderr, "Buy more RAM!\n");
+        exit(EXIT_FAILURE);
+    }
+    srand(seed);
+    for (size_t y = 0U; y < size; y++)
+    {
+        for (size_t x = 0U; x < size; x++)
+            buffers[0][y * (size + 1U) + x] = word[(unsigned int)rand() % (sizeof(word) - 1U)];
+        buffers[0][y * (size + 1U) + size] = '\n';
+    }
+    memcpy(buffers[1], buffers[0], buffer_size);
+
+    const char* layouts[2] = {"row-major", "tiled"};
+    grid2d_config_t configs[2] =
+    {
+        {.options = PLIB_GRID2D_NO_FLAGS},
+        {.options = PLIB_GRID2D_NO_FLAGS | PLIB_GRID2D_TILED}
+    };
+    grid2d_t* grids[2];
+    for (size_t l = 0U; l < 2U; l++)
+    {
+        grids[l] = grid2d_init_buffer(buffers[l], buffer_size, &configs[l]);
+        if (grids[l] == NULL)
+        {
+            fprintf(stderr, "Buy more RAM!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    const kernel_t kernels[] =
+    {
+        {"words down/diagonal", words_vertical_diagonal},
+        {"columns", columns},
+        {"rows", rows}
+    };
+
+    printf("grid %zu x %zu, best of %u runs [ms]\n\n", size, size, RUNS);
+    printf("%-20s %12s %12s %8s\n", "kernel", layouts[0], layouts[1], "ratio");
+    int ok = 1;
+    for (size_t k = 0U; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+    {
+        size_t results[2];
+        double times[2];
+        for (size_t l = 0U; l < 2U; l++)
+            times[l] = measure(&kernels[k], grids[l], &results[l]);
+        printf("%-20s %12.2f %12.2f %8.2f\n", kernels[k].name, times[0], times[1], times[1] / times[0]);
+        if (results[0] != results[1])
+        {
+            fprintf(stderr, "%s: results differ (%zu, %zu)\n", kernels[k].name, results[0], results[1]);
+            ok = 0;
+        }
+    }
+
+    for (size_t l = 0U; l < 2U; l++)
+    {
+        grid2d_free(grids[l]);
+        free(buffers[l]);
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
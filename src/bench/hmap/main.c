@@ -0,0 +1,358 @@
+/*
+ * Benchmark of plib_hmap against the list based solutions of day 1 and 11.
+ *
+ * Day 1 part 2: count how often each number of the left list occurs in the
+ * right list. Binary search in the sorted right list (sorting is done for
+ * part 1 anyway and not timed) vs. a histogram of the right list in a map.
+ *
+ * Day 11: stones after a number of blinks. One list node per stone, split
+ * stones inserted after their node (nodes from a plib_arena) vs. the count of
+ * stones per number in two maps.
+ *
+ * Usage: program [list size] [blinks] [seed]
+ *
+ * (C) Copyright 2024 "piscilus" Julian Kraemer
+ *
+ * Distributed under MIT license.
+ * See file LICENSE for details or copy at https://opensource.org/licenses/MIT
+ */
+
+#define PLIB_ARENA_IMPLEMENTATION
+#define PLIB_ARENA_NO_NAMESPACE
+#include "plib_arena.h"
+
+#define PLIB_HMAP_IMPLEMENTATION
+#define PLIB_HMAP_NO_NAMESPACE
+#include "plib_hmap.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define RUNS (3U)
+
+/* location ids of day 1 are 5 digits */
+#define LOCATIONS (100000U)
+
+static double
+now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static int
+compare_ints(const void* a, const void* b)
+{
+    int arg1 = *(const int*)a;
+    int arg2 = *(const int*)b;
+
+    return (arg1 > arg2) - (arg1 < arg2);
+}
+
+static const int*
+find_first(const int* arr, size_t n, int key)
+{
+    size_t low = 0U;
+    size_t high = n;
+    const int* result = NULL;
+
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2U;
+        if (arr[mid] < key)
+        {
+            low = mid + 1U;
+        }
+        else if (arr[mid] > key)
+        {
+            high = mid;
+        }
+        else
+        {
+            result = &arr[mid];
+            high = mid;
+        }
+    }
+
+    return result;
+}
+
+/* Similarity score, both lists sorted */
+static uint64_t
+similarity_search(const int* left, const int* right, size_t n)
+{
+    uint64_t score = 0U;
+    size_t i = 0U;
+    while (i < n)
+    {
+        int current = left[i];
+        const int* v = find_first(right, n, current);
+        uint64_t count = 0U;
+        for (size_t ci = (v != NULL) ? (size_t)(v - right) : n; (ci < n) && (right[ci] == current); ci++)
+            count++;
+        for (; (i < n) && (left[i] == current); i++)
+            score += (uint64_t)current * count;
+    }
+
+    return score;
+}
+
+/* Similarity score, order of the lists does not matter */
+static uint64_t
+similarity_map(const int* left, const int* right, size_t n)
+{
+    hmap_t counts;
+    if (hmap_init(&counts, 0U) == NULL)
+        return 0U;
+    for (size_t i = 0U; i < n; i++)
+        hmap_add(&counts, (uint64_t)right[i], 1U);
+
+    uint64_t score = 0U;
+    for (size_t i = 0U; i < n; i++)
+    {
+        const uint64_t* count = hmap_get(&counts, (uint64_t)left[i]);
+        if (count != NULL)
+            score += (uint64_t)left[i] * *count;
+    }
+    hmap_free(&counts);
+
+    return score;
+}
+
+static uint64_t
+count_digits(uint64_t n)
+{
+    uint64_t count = 1U;
+    while (n >= 10U)
+    {
+        n /= 10U;
+        count++;
+    }
+
+    return count;
+}
+
+/* Power of ten splitting a number of the given (even) digits in halves */
+static uint64_t
+split_of(uint64_t digits)
+{
+    uint64_t split = 10U;
+    for (uint64_t hd = digits / 2U; hd > 1U; hd--)
+        split *= 10U;
+
+    return split;
+}
+
+/* Node of the former doubly linked list of day 11 */
+typedef struct stone
+{
+    uint64_t value;
+    struct stone* prev;
+    struct stone* next;
+} stone_t;
+
+static uint64_t
+stones_list(const uint64_t* initial, size_t n, size_t blinks)
+{
+    arena_t arena;
+    arena_init(&arena, 0U, 0U);
+
+    stone_t* head = NULL;
+    stone_t* tail = NULL;
+    for (size_t i = 0U; i < n; i++)
+    {
+        stone_t* s = arena_alloc(&arena, sizeof(stone_t));
+        if (s == NULL)
+            goto error;
+        *s = (stone_t){initial[i], tail, NULL};
+        if (tail == NULL)
+            head = s;
+        else
+            tail->next = s;
+        tail = s;
+    }
+
+    for (size_t b = 0U; b < blinks; b++)
+    {
+        for (stone_t* s = head; s != NULL; s = s->next)
+        {
+            uint64_t digits;
+            if (s->value == 0U)
+            {
+                s->value = 1U;
+            }
+            else if (((digits = count_digits(s->value)) % 2U) == 0U)
+            {
+                uint64_t split = split_of(digits);
+                stone_t* right = arena_alloc(&arena, sizeof(stone_t));
+                if (right == NULL)
+                    goto error;
+                *right = (stone_t){s->value % split, s, s->next};
+                if (s->next != NULL)
+                    s->next->prev = right;
+                s->value /= split;
+                s->next = right;
+                s = right;
+            }
+            else
+            {
+                s->value *= 2024U;
+            }
+        }
+    }
+
+    uint64_t count = 0U;
+    for (stone_t* s = head; s != NULL; s = s->next)
+        count++;
+    arena_free(&arena);
+
+    return count;
+
+error:
+    arena_free(&arena);
+    return 0U;
+}
+
+static uint64_t
+stones_map(const uint64_t* initial, size_t n, size_t blinks)
+{
+    hmap_t maps[2];
+    hmap_init(&maps[0], 0U);
+    hmap_init(&maps[1], 0U);
+
+    uint64_t count = 0U;
+    for (size_t i = 0U; i < n; i++)
+        if (hmap_add(&maps[0], initial[i], 1U) == NULL)
+            goto error;
+
+    for (size_t b = 0U; b < blinks; b++)
+    {
+        const hmap_t* stones = &maps[b % 2U];
+        hmap_t* next = &maps[(b + 1U) % 2U];
+        hmap_clear(next);
+
+        size_t it = 0U;
+        uint64_t value;
+        uint64_t c;
+        while (hmap_next(stones, &it, &value, &c))
+        {
+            uint64_t digits;
+            if (value == 0U)
+            {
+                if (hmap_add(next, 1U, c) == NULL)
+                    goto error;
+            }
+            else if (((digits = count_digits(value)) % 2U) == 0U)
+            {
+                uint64_t split = split_of(digits);
+                if (   (hmap_add(next, value / split, c) == NULL)
+                    || (hmap_add(next, value % split, c) == NULL))
+                    goto error;
+            }
+            else
+            {
+                if (hmap_add(next, value * 2024U, c) == NULL)
+                    goto error;
+            }
+        }
+    }
+
+    size_t it = 0U;
+    uint64_t c;
+    while (hmap_next(&maps[blinks % 2U], &it, NULL, &c))
+        count += c;
+
+error:
+    hmap_free(&maps[0]);
+    hmap_free(&maps[1]);
+
+    return count;
+}
+
+typedef struct
+{
+    double time;
+    uint64_t result;
+} timing_t;
+
+#define MEASURE(t, expr) \
+    do \
+    { \
+        for (size_t r_ = 0U; r_ < RUNS; r_++) \
+        { \
+            double start_ = now(); \
+            (t).result = (expr); \
+            double d_ = (now() - start_) * 1e3; \
+            if ((r_ == 0U) || (d_ < (t).time)) \
+                (t).time = d_; \
+        } \
+    } while (0)
+
+static int
+report(const char* name, const char* before, const timing_t* a, const timing_t* b)
+{
+    printf("%-28s %-16s %10.2f ms\n", name, before, a->time);
+    printf("%-28s %-16s %10.2f ms   (%.2fx)\n", "", "plib_hmap", b->time, a->time / b->time);
+    if (a->result != b->result)
+    {
+        fprintf(stderr, "%s: results differ (%llu, %llu)\n", name,
+                (unsigned long long)a->result, (unsigned long long)b->result);
+        return 0;
+    }
+
+    return 1;
+}
+
+int
+main(int argc, char** argv)
+{
+    size_t n = (argc > 1) ? strtoul(*(argv + 1), NULL, 10) : 1000000U;
+    size_t blinks = (argc > 2) ? strtoul(*(argv + 2), NULL, 10) : 25U;
+    unsigned int seed = (argc > 3) ? (unsigned int)strtoul(*(argv + 3), NULL, 10) : 1U;
+
+    int* left = malloc(n * sizeof(int));
+    int* right = malloc(n * sizeof(int));
+    if ((n == 0U) || (left == NULL) || (right == NULL))
+    {
+        fprintf(stderr, "Invalid size or out of memory.\n");
+        exit(EXIT_FAILURE);
+    }
+    srand(seed);
+    for (size_t i = 0U; i < n; i++)
+    {
+        left[i] = (int)((unsigned int)rand() % LOCATIONS);
+        right[i] = (int)((unsigned int)rand() % LOCATIONS);
+    }
+
+    /* a puzzle input has 8 stones of up to 7 digits */
+    uint64_t stones[8];
+    for (size_t i = 0U; i < sizeof(stones) / sizeof(stones[0]); i++)
+        stones[i] = (uint64_t)rand() % 10000000U;
+
+    printf("best of %u runs\n\n", RUNS);
+    int ok = 1;
+    timing_t a = {0};
+    timing_t b = {0};
+
+    MEASURE(b, similarity_map(left, right, n));
+    qsort(left, n, sizeof(int), compare_ints);
+    qsort(right, n, sizeof(int), compare_ints);
+    MEASURE(a, similarity_search(left, right, n));
+    char name[64];
+    snprintf(name, sizeof(name), "day 1, %zu numbers", n);
+    ok &= report(name, "binary search", &a, &b);
+
+    MEASURE(a, stones_list(stones, 8U, blinks));
+    MEASURE(b, stones_map(stones, 8U, blinks));
+    snprintf(name, sizeof(name), "day 11, %zu blinks", blinks);
+    ok &= report(name, "list", &a, &b);
+    printf("%-28s %llu stones\n", "", (unsigned long long)b.result);
+
+    free(left);
+    free(right);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
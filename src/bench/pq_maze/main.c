@@ -0,0 +1,154 @@
+/*
+ * Benchmark of the plib_pq kinds on the search of day 16.
+ *
+ * Generates a maze of size x size tiles (default 1501) surrounded by a wall,
+ * each inner tile open with probability 0.72, S in the bottom left and E in
+ * the top right corner, and writes it to a file (default maze.txt), which can
+ * be passed to day 16 as well. Then times the solution of day 16 (reindeer.h,
+ * both searches on the grid2d path engine) with each kind of queue. For some
+ * seeds S or E lies in a closed off pocket, then all states reachable are
+ * searched but there is no best path.
+ *
+ * Usage: program [size] [seed] [file]
+ *
+ * (C) Copyright 2024 "piscilus" Julian Kraemer
+ *
+ * Distributed under MIT license.
+ * See file LICENSE for details or copy at https://opensource.org/licenses/MIT
+ */
+
+#define PLIB_GRID2D_IMPLEMENTATION
+#define PLIB_GRID2D_NO_NAMESPACE
+#include "plib_grid2d.h"
+
+#include "reindeer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define RUNS (3U)
+
+#define OPEN_PERCENT (72U)
+
+static double
+now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static int
+write_maze(const char* file_path, size_t size, unsigned int seed)
+{
+    FILE* fp = fopen(file_path, "w");
+    if (fp == NULL)
+    {
+        perror("Could not open file");
+        return 0;
+    }
+
+    srand(seed);
+    for (size_t y = 0U; y < size; y++)
+    {
+        for (size_t x = 0U; x < size; x++)
+        {
+            char c;
+            if ((y == 0U) || (x == 0U) || (y == size - 1U) || (x == size - 1U))
+                c = '#';
+            else if ((y == size - 2U) && (x == 1U))
+                c = 'S';
+            else if ((y == 1U) && (x == size - 2U))
+                c = 'E';
+            else
+                c = (((unsigned int)rand() % 100U) < OPEN_PERCENT) ? '.' : '#';
+            fputc(c, fp);
+        }
+        fputc('\n', fp);
+    }
+
+    return fclose(fp) == 0;
+}
+
+int
+main(int argc, char** argv)
+{
+    size_t size = (argc > 1) ? strtoul(*(argv + 1), NULL, 10) : 1501U;
+    unsigned int seed = (argc > 2) ? (unsigned int)strtoul(*(argv + 2), NULL, 10) : 2U;
+    const char* file_path = (argc > 3) ? *(argv + 3) : "maze.txt";
+    if (size < 4U)
+    {
+        fprintf(stderr, "Invalid size.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!write_maze(file_path, size, seed))
+        exit(EXIT_FAILURE);
+
+    grid2d_config_t config = {.options = PLIB_GRID2D_NO_FLAGS | PLIB_GRID2D_CHAR_INDEX, .border = 1U, .sentinel = '#'};
+    grid2d_t* g = grid2d_init_ex((char*)file_path, &config);
+    if (g == NULL)
+    {
+        fprintf(stderr, "Input error.\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t num;
+    size_t start = grid2d_positions(g, 'S', &num)[0];
+    size_t end = grid2d_positions(g, 'E', &num)[0];
+    g->cells[start] = '.';
+    g->cells[end] = '.';
+
+    const struct
+    {
+        const char* name;
+        int kind;
+    } kinds[] =
+    {
+        {"bucket", PLIB_PQ_BUCKET},
+        {"radix", PLIB_PQ_RADIX},
+        {"heap", PLIB_PQ_HEAP}
+    };
+
+    printf("maze %zu x %zu (%s), %zu states, best of %u runs\n\n",
+           size, size, file_path, g->num_cells * 4U, RUNS);
+    printf("%-8s %12s %12s %8s\n", "queue", "time [ms]", "score", "tiles");
+    int ok = 1;
+    reindeer_result_t first = {0};
+    for (size_t k = 0U; k < sizeof(kinds) / sizeof(kinds[0]); k++)
+    {
+        reindeer_result_t r;
+        double best = 0.0;
+        int solved = 1;
+        for (size_t run = 0U; (run < RUNS) && solved; run++)
+        {
+            double t0 = now();
+            solved = (reindeer_solve(g, start, end, kinds[k].kind, &r) != NULL);
+            double t = (now() - t0) * 1e3;
+            if ((run == 0U) || (t < best))
+                best = t;
+        }
+        if (!solved)
+        {
+            fprintf(stderr, "Buy more RAM!\n");
+            ok = 0;
+            break;
+        }
+        printf("%-8s %12.1f %12d %8zu\n", kinds[k].name, best, r.best, r.tiles);
+        if (k == 0U)
+        {
+            first = r;
+        }
+        else if ((r.best != first.best) || (r.tiles != first.tiles))
+        {
+            fprintf(stderr, "%s: results differ\n", kinds[k].name);
+            ok = 0;
+        }
+    }
+    if (ok && (first.best < 0))
+        printf("\nNo path from S to E, try another seed.\n");
+
+    grid2d_free(g);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
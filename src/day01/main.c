@@ -65,7 +65,7 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    flr_t* f = flr_init(*(argv + 1));
+    flr_t* f = flr_init_ex(*(argv + 1), PLIB_FLR_PARALLEL);
 
     size_t num_locations = flr_num_lines(f);
     if (num_locations == 0U)
@@ -93,10 +93,12 @@ main(int argc, char** argv)
     }
 
     const char* p;
+    size_t length;
     size_t i = 0U;
-    while((p = flr_get_next_line(f, NULL)) != NULL)
+    while((p = flr_get_next_line_ex(f, NULL, &length)) != NULL)
     {
-        if (sscanf(p, "%d %d", left + i, right + i) != 2)
+        long long v[2];
+        if (flr_parse_ints(p, length, v, 2U) != 2U)
         {
             fprintf(stderr, "Error in the data, line %zu: '%s'\n", i, p);
             free(left);
@@ -104,6 +106,8 @@ main(int argc, char** argv)
             flr_free(f);
             exit(EXIT_FAILURE);
         }
+        left[i] = (int)v[0];
+        right[i] = (int)v[1];
         i++;
     }
 
@@ -7,6 +7,10 @@
  * See file LICENSE for details or copy at https://opensource.org/licenses/MIT
  */
 
+#define PLIB_ARENA_IMPLEMENTATION
+#define PLIB_ARENA_NO_NAMESPACE
+#include "plib_arena.h"
+
 #define PLIB_FLR_IMPLEMENTATION
 #define PLIB_FLR_NO_NAMESPACE
 #include "plib_flr.h"
@@ -65,34 +69,32 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    flr_t* f = flr_init(*(argv + 1));
-
-    size_t num_locations = flr_num_lines(f);
-    if (num_locations == 0U)
-    {
-        fprintf(stderr, "File empty?!\n");
-        flr_free(f);
+    /* open and read errors are reported by flr */
+    flr_t* f = flr_init_stream_ex(*(argv + 1), 0U, PLIB_FLR_PREFETCH);
+    if (f == NULL)
         exit(EXIT_FAILURE);
-    }
+
+    /* numbers of one report, released per line */
+    arena_t arena;
+    arena_init(&arena, 0U, 0U);
 
     int result_p1 = 0;
     int result_p2 = 0;
     const char* p;
-    while ((p = flr_get_next_line(f, NULL)) != NULL)
+    size_t line = 0U;
+    size_t length;
+    while ((p = flr_get_next_line_ex(f, &line, &length)) != NULL)
     {
+        arena_reset(&arena);
         size_t count = 0U;
-        int* numbers = malloc(strlen(p) * sizeof(int));
+        int* numbers = arena_alloc(&arena, length * sizeof(int));
         if (numbers == NULL)
             break;
-        char* line = strdup(p);
-        assert(line != NULL);
-        char *token = strtok(line, " ");
-        while(token)
-        {
-            numbers[count] = atoi(token);
-            token = strtok(NULL, " ");
-            count++;
-        }
+        flr_cursor_t c;
+        long long v;
+        flr_cursor_init(&c, p, length);
+        while (flr_next_int(&c, &v) != NULL)
+            numbers[count++] = (int)v;
         assert(count > 1U);
         if (validate(numbers, count))
         {
@@ -100,7 +102,7 @@ main(int argc, char** argv)
         }
         else
         {
-            int* numbers_reduced = malloc((count - 1U) * sizeof(int));
+            int* numbers_reduced = arena_alloc(&arena, (count - 1U) * sizeof(int));
             assert(numbers_reduced != NULL);
             for (size_t j = 0U; j < count; j++)
             {
@@ -118,15 +120,21 @@ main(int argc, char** argv)
                     break;
                 }
             }
-            free(numbers_reduced);
         }
-        free(line);
-        free(numbers);
+    }
+
+    if (line == 0U)
+    {
+        fprintf(stderr, "File empty?!\n");
+        arena_free(&arena);
+        flr_free(f);
+        exit(EXIT_FAILURE);
     }
 
     printf("Part 1: Number of safe reports = %d\n", result_p1);
     printf("Part 2: Number of safe reports = %d\n", result_p1 + result_p2);
 
+    arena_free(&arena);
     flr_free(f);
 
     return EXIT_SUCCESS;
@@ -11,17 +11,21 @@
 #define PLIB_GRID2D_NO_NAMESPACE
 #include "plib_grid2d.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-static int
-count_xmas(grid2d_t* g, const char* p)
+/* Count words starting in the rows of the band, reads p_size - 1 rows below */
+static void
+count_xmas(grid2d_band_t* band)
 {
-    int c = 0;
+    const grid2d_t* g = band->g;
+    const char* p = band->ctx;
+    size_t* c = band->result;
     size_t p_size = strlen(p);
 
-    for (size_t y = 0U; y < g->max_y; y++)
+    for (size_t y = band->y_begin; y < band->y_end; y++)
     {
         for (size_t x = 0U; x < g->max_x; x++)
         {
@@ -59,34 +63,37 @@ count_xmas(grid2d_t* g, const char* p)
             }
             for (size_t i = 0U; i < (sizeof(count) / sizeof(count[0])); i++)
                 if (count[i] == p_size)
-                    c++;
+                    (*c)++;
         }
     }
-
-    return c;
 }
 
 
 static int
 count_x_mas(grid2d_t* g)
 {
-    int c = 0;
+    const uint64_t* a = grid2d_bitplane(g, 'A');
+    const uint64_t* m = grid2d_bitplane(g, 'M');
+    const uint64_t* s = grid2d_bitplane(g, 'S');
+    if ((a == NULL) || (m == NULL) || (s == NULL))
+        return -1;
 
+    /* 64 cells at once: A with M and S on both diagonals */
+    int c = 0;
+    size_t words = g->bitplane_words;
     for (size_t y = 1U; y < g->max_y - 1U; y++)
     {
-        for (size_t x = 1U; x < g->max_x - 1U; x++)
+        const uint64_t* mu = m + (y - 1U) * words;
+        const uint64_t* su = s + (y - 1U) * words;
+        const uint64_t* md = m + (y + 1U) * words;
+        const uint64_t* sd = s + (y + 1U) * words;
+        for (size_t w = 0U; w < words; w++)
         {
-            if (   (g->grid[y][x] == 'A')
-                && (   (   (g->grid[y - 1U][x - 1U] == 'S')
-                        && (g->grid[y + 1U][x + 1U] == 'M'))
-                    || (   (g->grid[y - 1U][x - 1U] == 'M')
-                        && (g->grid[y + 1U][x + 1U] == 'S')))
-
-                && (   (   (g->grid[y - 1U][x + 1U] == 'S')
-                        && (g->grid[y + 1U][x - 1U] == 'M'))
-                    || (   (g->grid[y - 1U][x + 1U] == 'M')
-                        && (g->grid[y + 1U][x - 1U] == 'S'))))
-                c++;
+            uint64_t diag1 = (grid2d_bits_west(su, w) & grid2d_bits_east(md, w, words))
+                           | (grid2d_bits_west(mu, w) & grid2d_bits_east(sd, w, words));
+            uint64_t diag2 = (grid2d_bits_east(su, w, words) & grid2d_bits_west(md, w))
+                           | (grid2d_bits_east(mu, w, words) & grid2d_bits_west(sd, w));
+            c += __builtin_popcountll(a[y * words + w] & diag1 & diag2);
         }
     }
 
@@ -110,8 +117,16 @@ main(int argc, char** argv)
     printf("maxy %zu maxx %zu\n", g->max_y, g->max_x);
 #endif
 
-    int cp1 = count_xmas(g, "XMAS");
-    printf("Part 1: XMAS count = %d\n", cp1);
+    static const char xmas[] = "XMAS";
+    size_t cp1 = 0U;
+    if (grid2d_reduce(g, sizeof(xmas) - 2U, 0U, count_xmas, (void*)xmas,
+                      &cp1, sizeof(cp1), grid2d_combine_sum) == NULL)
+    {
+        fprintf(stderr, "Memory allocation error.\n");
+        grid2d_free(g);
+        exit(EXIT_FAILURE);
+    }
+    printf("Part 1: XMAS count = %zu\n", cp1);
 
     int cp2 = count_x_mas(g);
     printf("Part 2: X-MAS count = %d\n", cp2);
@@ -7,6 +7,10 @@
  * See file LICENSE for details or copy at https://opensource.org/licenses/MIT
  */
 
+#define PLIB_ARENA_IMPLEMENTATION
+#define PLIB_ARENA_NO_NAMESPACE
+#include "plib_arena.h"
+
 #define PLIB_FLR_IMPLEMENTATION
 #define PLIB_FLR_NO_NAMESPACE
 #include "plib_flr.h"
@@ -32,7 +36,7 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    flr_t* f = flr_init(*(argv + 1));
+    flr_t* f = flr_init_ex(*(argv + 1), PLIB_FLR_LAZY);
 
     size_t num_locations = flr_num_lines(f);
     if (num_locations == 0U)
@@ -42,7 +46,10 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    rule_t* rules = malloc(sizeof(rule_t) * num_locations);
+    arena_t arena;
+    arena_init(&arena, 0U, 0U);
+
+    rule_t* rules = arena_alloc(&arena, sizeof(rule_t) * num_locations);
     if (rules == NULL)
     {
         fprintf(stderr, "Buy more RAM!\n");
@@ -52,14 +59,20 @@ main(int argc, char** argv)
 
     int num_rules = 0;
     const char* p;
-    while ((p = flr_get_next_line(f, NULL)) != NULL)
+    size_t len;
+    while ((p = flr_get_next_line_ex(f, NULL, &len)) != NULL)
     {
-        if (strlen(p) == 0U)
+        if (len == 0U)
             break;
         else
         {
-            sscanf(p, "%d|%d", &rules[num_rules].x, &rules[num_rules].y);
-            num_rules++;
+            long long v[2];
+            if (flr_parse_ints(p, len, v, 2U) == 2U)
+            {
+                rules[num_rules].x = (int)v[0];
+                rules[num_rules].y = (int)v[1];
+                num_rules++;
+            }
         }
     }
 #if 0
@@ -69,21 +82,22 @@ main(int argc, char** argv)
         printf("%d %d %d\n", i, rules[i].x, rules[i].y);
     }
 #endif
+    /* pages of one update, released per line */
+    arena_mark_t update = arena_mark(&arena);
+
     int result = 0;
-    while ((p = flr_get_next_line(f, NULL)) != NULL)
+    while ((p = flr_get_next_line_ex(f, NULL, &len)) != NULL)
     {
-        size_t len = strlen(p);
+        arena_release(&arena, update);
         size_t num_pages = 0U;
-        int* pages = malloc(len * sizeof(int));
+        int* pages = arena_alloc(&arena, len * sizeof(int));
         if (pages == NULL)
             break;
-        char *token = strtok(p, ",");
-        while(token)
-        {
-            pages[num_pages] = atoi(token);
-            token = strtok(NULL, ",");
-            num_pages++;
-        }
+        flr_cursor_t c;
+        long long v;
+        flr_cursor_init(&c, p, len);
+        while (flr_next_int(&c, &v) != NULL)
+            pages[num_pages++] = (int)v;
         int correct = 1;
         for (size_t page = 0U; page < num_pages; page++)
         {
@@ -116,10 +130,10 @@ main(int argc, char** argv)
         stop:
         if (correct)
             result += pages[num_pages / 2U];
-        free(pages);
     }
     printf("Part 1: %d\n", result);
 
+    arena_free(&arena);
     flr_free(f);
 
     return EXIT_SUCCESS;
@@ -38,20 +38,15 @@ static const char dir_chars[] = { DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT };
 int
 determine_start(grid2d_t* grid, guard_t* guard)
 {
-    for (size_t y = 0U; y < grid->max_y; y++)
+    for (size_t i = 0U; i < (sizeof(dir_chars)/sizeof(dir_chars[0])); i++)
     {
-        for (size_t x = 0U; x < grid->max_x; x++)
+        size_t count;
+        const size_t* positions = grid2d_positions(grid, dir_chars[i], &count);
+        if (count > 0U)
         {
-            for (size_t i = 0U; i < (sizeof(dir_chars)/sizeof(dir_chars[0])); i++)
-            {
-                if (grid->grid[y][x] == dir_chars[i])
-                {
-                    guard->pos.y = y;
-                    guard->pos.x = x;
-                    guard->dir = dir_chars[i];
-                    return 1;
-                }
-            }
+            grid2d_coords(grid, positions[0], &guard->pos.y, &guard->pos.x);
+            guard->dir = dir_chars[i];
+            return 1;
         }
     }
     return 0;
@@ -83,7 +78,8 @@ turn(guard_t* guard)
 static int
 walk(grid2d_t* grid, guard_t* guard)
 {
-    grid->flags[guard->pos.y][guard->pos.x] = 1U;
+    grid2d_layer_t* visited = grid2d_layer(grid, "visited");
+    grid2d_layer_set(visited, PLIB_GRID2D_INDEX(grid, guard->pos.y, guard->pos.x), 1U);
     int walking = 1;
     while (walking)
     {
@@ -93,7 +89,7 @@ walk(grid2d_t* grid, guard_t* guard)
                 if (guard->pos.y == 0U)
                     walking = 0;
                 else
-                    if (grid->grid[guard->pos.y - 1][guard->pos.x] == OBSTACLE)
+                    if (*grid2d_at(grid, guard->pos.y - 1, guard->pos.x) == OBSTACLE)
                         turn(guard);
                     else
                         guard->pos.y -= 1U;
@@ -102,7 +98,7 @@ walk(grid2d_t* grid, guard_t* guard)
                 if (guard->pos.y == grid->max_y - 1U)
                     walking = 0;
                 else
-                    if (grid->grid[guard->pos.y + 1U][guard->pos.x] == OBSTACLE)
+                    if (*grid2d_at(grid, guard->pos.y + 1U, guard->pos.x) == OBSTACLE)
                         turn(guard);
                     else
                         guard->pos.y += 1U;
@@ -111,7 +107,7 @@ walk(grid2d_t* grid, guard_t* guard)
                 if (guard->pos.x == 0U)
                     walking = 0;
                 else
-                    if (grid->grid[guard->pos.y][guard->pos.x - 1U] == OBSTACLE)
+                    if (*grid2d_at(grid, guard->pos.y, guard->pos.x - 1U) == OBSTACLE)
                         turn(guard);
                     else
                         guard->pos.x -= 1U;
@@ -120,7 +116,7 @@ walk(grid2d_t* grid, guard_t* guard)
                 if (guard->pos.x == grid->max_x - 1U)
                     walking = 0;
                 else
-                    if (grid->grid[guard->pos.y][guard->pos.x + 1U] == OBSTACLE)
+                    if (*grid2d_at(grid, guard->pos.y, guard->pos.x + 1U) == OBSTACLE)
                         turn(guard);
                     else
                         guard->pos.x += 1U;
@@ -129,16 +125,128 @@ walk(grid2d_t* grid, guard_t* guard)
                 assert(0);
                 break;
         }
-        grid->flags[guard->pos.y][guard->pos.x] = 1U;
+        grid2d_layer_set(visited, PLIB_GRID2D_INDEX(grid, guard->pos.y, guard->pos.x), 1U);
+    }
+
+    return (int)grid2d_layer_count(visited, 1U);
+}
+
+static uint32_t
+dir_bit(char dir)
+{
+    for (size_t i = 0U; i < (sizeof(dir_chars)/sizeof(dir_chars[0])); i++)
+        if (dir_chars[i] == dir)
+            return 1U << i;
+    assert(0);
+    return 0U;
+}
+
+/* Walk on the snapshot until leaving the grid or entering a loop */
+static int
+is_loop(grid2d_snapshot_t* snapshot, grid2d_epoch_t* seen, guard_t guard)
+{
+    const grid2d_t* grid = snapshot->base;
+    grid2d_epoch_next(seen);
+    for (;;)
+    {
+        size_t i = PLIB_GRID2D_INDEX(grid, guard.pos.y, guard.pos.x);
+        uint32_t bit = dir_bit(guard.dir);
+        if (grid2d_epoch_get(seen, i) & bit)
+            return 1;
+        grid2d_epoch_add(seen, i, bit);
+
+        coord_t next = guard.pos;
+        switch (guard.dir)
+        {
+            case DIR_UP:
+                if (next.y == 0U)
+                    return 0;
+                next.y -= 1U;
+                break;
+            case DIR_DOWN:
+                if (next.y == grid->max_y - 1U)
+                    return 0;
+                next.y += 1U;
+                break;
+            case DIR_LEFT:
+                if (next.x == 0U)
+                    return 0;
+                next.x -= 1U;
+                break;
+            case DIR_RIGHT:
+                if (next.x == grid->max_x - 1U)
+                    return 0;
+                next.x += 1U;
+                break;
+            default:
+                assert(0);
+                break;
+        }
+        if (grid2d_snapshot_get(snapshot, PLIB_GRID2D_INDEX(grid, next.y, next.x)) == OBSTACLE)
+            turn(&guard);
+        else
+            guard.pos = next;
+    }
+}
+
+typedef struct
+{
+    const guard_t* start;
+    const grid2d_layer_t* visited;
+} trials_t;
+
+typedef struct
+{
+    int loops;
+    int errors;
+} trials_result_t;
+
+/* Place an obstacle on each visited cell of the band but the start */
+static void
+count_loops(grid2d_band_t* band)
+{
+    const trials_t* trials = band->ctx;
+    trials_result_t* result = band->result;
+    const grid2d_t* grid = band->g;
+
+    grid2d_snapshot_t snapshot;
+    grid2d_epoch_t seen;
+    if (grid2d_snapshot_init(&snapshot, grid) == NULL)
+    {
+        result->errors++;
+        return;
+    }
+    if (grid2d_epoch_init(&seen, grid) == NULL)
+    {
+        grid2d_snapshot_free(&snapshot);
+        result->errors++;
+        return;
     }
 
-    int count = 0;
-    for (size_t y = 0U; y < grid->max_y; y++)
+    size_t start_index = PLIB_GRID2D_INDEX(grid, trials->start->pos.y, trials->start->pos.x);
+    for (size_t y = band->y_begin; y < band->y_end; y++)
+    {
         for (size_t x = 0U; x < grid->max_x; x++)
-            if (grid->flags[y][x] > 0U)
-                count++;
+        {
+            size_t i = PLIB_GRID2D_INDEX(grid, y, x);
+            if ((i == start_index) || !grid2d_layer_get(trials->visited, i))
+                continue;
+            grid2d_snapshot_reset(&snapshot);
+            grid2d_snapshot_set(&snapshot, i, OBSTACLE);
+            result->loops += is_loop(&snapshot, &seen, *trials->start);
+        }
+    }
 
-    return count;
+    grid2d_epoch_free(&seen);
+    grid2d_snapshot_free(&snapshot);
+}
+
+static void
+add_trials(void* acc, const void* result, void* ctx)
+{
+    (void)ctx;
+    ((trials_result_t*)acc)->loops += ((const trials_result_t*)result)->loops;
+    ((trials_result_t*)acc)->errors += ((const trials_result_t*)result)->errors;
 }
 
 int
@@ -152,7 +260,9 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    grid2d_t* g = grid2d_init(*(argv + 1));
+    static const grid2d_layer_def_t layers[] = {{"visited", PLIB_GRID2D_BIT}};
+    grid2d_config_t config = {.options = PLIB_GRID2D_NO_FLAGS | PLIB_GRID2D_CHAR_INDEX, .layers = layers, .num_layers = 1U};
+    grid2d_t* g = grid2d_init_ex(*(argv + 1), &config);
     if (g == NULL)
     {
         fprintf(stderr, "Input error.\n");
@@ -167,10 +277,22 @@ main(int argc, char** argv)
     guard_t guard = {0};
     int r = determine_start(g, &guard);
     assert(r);
+    const guard_t start = guard;
 
     r = walk(g, &guard);
     printf("Part 1: %d\n", r);
 
+    trials_t trials = {.start = &start, .visited = grid2d_layer(g, "visited")};
+    trials_result_t loops = {0};
+    if (   (grid2d_reduce(g, 0U, 0U, count_loops, &trials, &loops, sizeof(loops), add_trials) == NULL)
+        || (loops.errors > 0))
+    {
+        fprintf(stderr, "Memory allocation error.\n");
+        grid2d_free(g);
+        exit(EXIT_FAILURE);
+    }
+    printf("Part 2: %d\n", loops.loops);
+
     grid2d_free(g);
 
     return EXIT_SUCCESS;
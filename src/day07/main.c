@@ -7,6 +7,10 @@
  * See file LICENSE for details or copy at https://opensource.org/licenses/MIT
  */
 
+#define PLIB_ARENA_IMPLEMENTATION
+#define PLIB_ARENA_NO_NAMESPACE
+#include "plib_arena.h"
+
 #define PLIB_FLR_IMPLEMENTATION
 #define PLIB_FLR_NO_NAMESPACE
 #include "plib_flr.h"
@@ -28,31 +32,27 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    flr_t* f = flr_init(*(argv + 1));
-    if (flr_num_lines(f) == 0U)
-    {
-        fprintf(stderr, "File empty?!\n");
-        flr_free(f);
+    /* open and read errors are reported by flr */
+    flr_t* f = flr_init_stream_ex(*(argv + 1), 0U, PLIB_FLR_PREFETCH);
+    if (f == NULL)
         exit(EXIT_FAILURE);
-    }
+
+    /* numbers of one equation, released per line */
+    arena_t arena;
+    arena_init(&arena, 0U, 0U);
 
     long long total_calibration_result = 0;
     const char* p;
-    while ((p = flr_get_next_line(f, NULL)) != NULL)
+    size_t line = 0U;
+    size_t length;
+    while ((p = flr_get_next_line_ex(f, &line, &length)) != NULL)
     {
+        arena_reset(&arena);
         size_t count = 0U;
-        long long* numbers = malloc(strlen(p) * sizeof(long long));
+        long long* numbers = arena_alloc(&arena, length * sizeof(long long));
         if (numbers == NULL)
             break;
-        char* line = strdup(p);
-        assert(line != NULL);
-        char *token = strtok(line, " ");
-        while(token)
-        {
-            numbers[count] = atoll(token);
-            token = strtok(NULL, " ");
-            count++;
-        }
+        count = flr_parse_ints(p, length, numbers, length);
         assert(count > 2U);
         size_t num_operations = count - 2U;
         size_t combinations = pow(2, num_operations);
@@ -72,11 +72,18 @@ main(int argc, char** argv)
                 break;
             }
         }
-        free(line);
-        free(numbers);
+    }
+
+    if (line == 0U)
+    {
+        fprintf(stderr, "File empty?!\n");
+        arena_free(&arena);
+        flr_free(f);
+        exit(EXIT_FAILURE);
     }
 
     printf("Part 1: %lld\n", total_calibration_result);
+    arena_free(&arena);
     flr_free(f);
 
     return EXIT_SUCCESS;
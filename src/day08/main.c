@@ -12,13 +12,13 @@
 #include "plib_grid2d.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #define DEBUGP(...) /*printf(__VA_ARGS__)*/
-#define NUM_PER_FREQUENCY (10)
-#define MARKER_FREQUENCY  (1U << 0U)
 #define MARKER_PART1      (1U << 1U)
 #define MARKER_PART2      (1U << 2U)
 
@@ -29,65 +29,62 @@ typedef struct
 } coord_t;
 
 static int
-place_antinode(grid2d_t* g, int y, int x, size_t marker)
+place_antinode(grid2d_t* g, uint8_t* markers, int y, int x, uint8_t marker)
 {
     if (   (y >= 0)
         && (y < (int)g->max_y)
         && (x >= 0)
         && (x < (int)g->max_x))
     {
-        g->flags[y][x] |= marker;
+        markers[PLIB_GRID2D_INDEX(g, (size_t)y, (size_t)x)] |= marker;
         return 1;
     }
     return 0;
 }
 
+static coord_t
+to_coord(grid2d_t* g, size_t i)
+{
+    size_t y;
+    size_t x;
+    grid2d_coords(g, i, &y, &x);
+    return (coord_t){.x = (int)x, .y = (int)y};
+}
+
 static void
-handle_frequency(grid2d_t* g, size_t sy, size_t sx)
+handle_frequency(grid2d_t* g, uint8_t* markers, char frequency)
 {
-    coord_t coords[NUM_PER_FREQUENCY] = {0};
-    int count = 0;
-    for (size_t y = 0U; y < g->max_y; y++)
+    size_t count;
+    const size_t* positions = grid2d_positions(g, frequency, &count);
+    assert(count > 0U);
+    for (size_t i = 0U; i < count - 1U; i++)
     {
-        for (size_t x = 0U; x < g->max_x; x++)
+        coord_t a = to_coord(g, positions[i]);
+        for (size_t j = i + 1U; j < count; j++)
         {
-            if (g->grid[y][x] == g->grid[sy][sx])
-            {
-                g->flags[y][x] |= MARKER_FREQUENCY;
-                assert(count < NUM_PER_FREQUENCY);
-                coords[count].y = (int)y;
-                coords[count].x = (int)x;
-                count++;
-            }
-        }
-    }
-    assert(count > 0); /* increase NUM_PER_FREQUENCY */
-    for (int i = 0; i < count - 1; i++)
-    {
-        for (int j = i + 1; j < count; j++)
-        {
-            int dist_y = (coords[i].y - coords[j].y);
-            int dist_x = (coords[i].x - coords[j].x);
-            place_antinode(g, coords[i].y + dist_y, coords[i].x + dist_x, MARKER_PART1);
-            place_antinode(g, coords[j].y - dist_y, coords[j].x - dist_x, MARKER_PART1);
-            int yy = coords[i].y;
-            int xx = coords[i].x;
-            g->flags[yy][xx] |= MARKER_PART2;
+            coord_t b = to_coord(g, positions[j]);
+            int dist_y = (a.y - b.y);
+            int dist_x = (a.x - b.x);
+            place_antinode(g, markers, a.y + dist_y, a.x + dist_x, MARKER_PART1);
+            place_antinode(g, markers, b.y - dist_y, b.x - dist_x, MARKER_PART1);
+            int yy = a.y;
+            int xx = a.x;
+            markers[PLIB_GRID2D_INDEX(g, (size_t)yy, (size_t)xx)] |= MARKER_PART2;
             do
             {
                 yy = yy + dist_y;
                 xx = xx + dist_x;
             }
-            while (place_antinode(g, yy, xx, MARKER_PART2));
-            yy = coords[j].y;
-            xx = coords[j].x;
-            g->flags[yy][xx] |= MARKER_PART2;
+            while (place_antinode(g, markers, yy, xx, MARKER_PART2));
+            yy = b.y;
+            xx = b.x;
+            markers[PLIB_GRID2D_INDEX(g, (size_t)yy, (size_t)xx)] |= MARKER_PART2;
             do
             {
                 yy = yy - dist_y;
                 xx = xx - dist_x;
             }
-            while (place_antinode(g, yy, xx, MARKER_PART2));
+            while (place_antinode(g, markers, yy, xx, MARKER_PART2));
         }
     }
 }
@@ -103,29 +100,26 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    grid2d_t* g = grid2d_init(*(argv + 1));
+    static const grid2d_layer_def_t layers[] = {{"markers", PLIB_GRID2D_U8}};
+    grid2d_config_t config = {.options = PLIB_GRID2D_NO_FLAGS | PLIB_GRID2D_CHAR_INDEX, .layers = layers, .num_layers = 1U};
+    grid2d_t* g = grid2d_init_ex(*(argv + 1), &config);
     if (g == NULL)
     {
         fprintf(stderr, "Input error.\n");
         exit(EXIT_FAILURE);
     }
 
-    for (size_t y = 0U; y < g->max_y; y++)
-        for (size_t x = 0U; x < g->max_x; x++)
-            if (   (g->grid[y][x] != '.')
-                && ((g->flags[y][x] & MARKER_FREQUENCY) == 0U))
-                handle_frequency(g, y, x);
+    grid2d_layer_t* markers = grid2d_layer(g, "markers");
+    for (int c = 1; c <= UCHAR_MAX; c++)
+    {
+        size_t count;
+        grid2d_positions(g, (char)c, &count);
+        if ((c != '.') && (count > 0U))
+            handle_frequency(g, markers->u8, (char)c);
+    }
 
-    int result_p1 = 0;
-    int result_p2 = 0;
-    for (size_t y = 0U; y < g->max_y; y++)
-        for (size_t x = 0U; x < g->max_x; x++)
-        {
-            if ((g->flags[y][x] & MARKER_PART1) != 0U)
-                result_p1++;
-            if ((g->flags[y][x] & MARKER_PART2) != 0U)
-                result_p2++;
-        }
+    int result_p1 = (int)grid2d_layer_count(markers, MARKER_PART1);
+    int result_p2 = (int)grid2d_layer_count(markers, MARKER_PART2);
 
     printf("Part 1: Number of unique antinodes = %d\n", result_p1);
     printf("Part 2: Number of unique antinodes = %d\n", result_p2);
@@ -15,39 +15,32 @@
 #include <stdlib.h>
 
 static void
-search_paths(grid2d_t* g, size_t y, size_t x, int height)
+search_paths(grid2d_t* g, grid2d_epoch_t* summits, size_t i, int height)
 {
     if (height == '9')
     {
-        g->flags[y][x]++;
+        grid2d_epoch_add(summits, i, 1U);
         return;
     }
+    /* no bounds checks, the grid is surrounded by a sentinel border */
     int next_height = height + 1;
-    if ((y > 0U) && (g->grid[y - 1U][x] == next_height))
-        search_paths(g, y - 1U, x, next_height);
-    if ((x > 0U) && (g->grid[y][x - 1U] == next_height))
-        search_paths(g, y, x - 1U, next_height);
-    if ((y < (g->max_y - 1U)) && (g->grid[y + 1U][x] == next_height))
-        search_paths(g, y + 1U, x, next_height);
-    if ((x < (g->max_x - 1U)) && (g->grid[y][x + 1U] == next_height))
-        search_paths(g, y, x + 1U, next_height);
+    if (g->cells[i - g->stride] == next_height)
+        search_paths(g, summits, i - g->stride, next_height);
+    if (g->cells[i - 1U] == next_height)
+        search_paths(g, summits, i - 1U, next_height);
+    if (g->cells[i + g->stride] == next_height)
+        search_paths(g, summits, i + g->stride, next_height);
+    if (g->cells[i + 1U] == next_height)
+        search_paths(g, summits, i + 1U, next_height);
 }
 
 static void
-count_and_clear(grid2d_t* g, int* p1, int* p2)
+count_and_clear(grid2d_epoch_t* summits, int* p1, int* p2)
 {
-    for (size_t y = 0U; y < g->max_y; y++)
-    {
-        for (size_t x = 0U; x < g->max_x; x++)
-        {
-            if (g->flags[y][x] != 0U)
-            {
-                (*p1)++;
-                *p2 += g->flags[y][x];
-                g->flags[y][x] = 0U;
-            }
-        }
-    }
+    *p1 += (int)summits->num_touched;
+    for (size_t i = 0U; i < summits->num_touched; i++)
+        *p2 += (int)grid2d_epoch_get(summits, summits->touched[i]);
+    grid2d_epoch_next(summits);
 }
 
 int
@@ -61,13 +54,22 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    grid2d_t* g = grid2d_init(*(argv + 1));
+    grid2d_config_t config = {.options = PLIB_GRID2D_NO_FLAGS, .border = 1U, .sentinel = ' '};
+    grid2d_t* g = grid2d_init_ex(*(argv + 1), &config);
     if (g == NULL)
     {
         fprintf(stderr, "Input error.\n");
         exit(EXIT_FAILURE);
     }
 
+    grid2d_epoch_t summits;
+    if (grid2d_epoch_init(&summits, g) == NULL)
+    {
+        fprintf(stderr, "Memory allocation error.\n");
+        grid2d_free(g);
+        exit(EXIT_FAILURE);
+    }
+
     int p1 = 0;
     int p2 = 0;
     for (size_t y = 0U; y < g->max_y; y++)
@@ -76,8 +78,8 @@ main(int argc, char** argv)
         {
             if (g->grid[y][x] == '0')
             {
-                search_paths(g, y, x, '0');
-                count_and_clear(g, &p1, &p2);
+                search_paths(g, &summits, PLIB_GRID2D_INDEX(g, y, x), '0');
+                count_and_clear(&summits, &p1, &p2);
             }
         }
     }
@@ -85,6 +87,7 @@ main(int argc, char** argv)
     printf("Part 1: %d\n", p1);
     printf("Part 2: %d\n", p2);
 
+    grid2d_epoch_free(&summits);
     grid2d_free(g);
 
     return EXIT_SUCCESS;
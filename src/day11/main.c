@@ -7,20 +7,23 @@
  * See file LICENSE for details or copy at https://opensource.org/licenses/MIT
  */
 
-#include "dll.h"
+#define PLIB_HMAP_IMPLEMENTATION
+#define PLIB_HMAP_NO_NAMESPACE
+#include "plib_hmap.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #define BLINKS (25U)
 
-static node_payload_t
-count_digits(node_payload_t n)
+static uint64_t
+count_digits(uint64_t n)
 {
     if (n == 0)
         return 1;
 
-    node_payload_t count = 0;
+    uint64_t count = 0;
     while (n != 0)
     {
         n = n / 10;
@@ -30,6 +33,49 @@ count_digits(node_payload_t n)
     return count;
 }
 
+/* Stones with the same number behave the same, count stones per number */
+static int
+blink(const hmap_t* stones, hmap_t* next)
+{
+    hmap_clear(next);
+
+    size_t it = 0U;
+    uint64_t value;
+    uint64_t count;
+    while (hmap_next(stones, &it, &value, &count))
+    {
+        if (value == 0U)
+        {
+            if (hmap_add(next, 1U, count) == NULL)
+                return 0;
+        }
+        else
+        {
+            uint64_t digits = count_digits(value);
+            if ((digits % 2U) == 0U)
+            {
+                uint64_t split = 10U;
+                uint64_t hd = digits / 2U;
+                while (hd > 1U)
+                {
+                    split *= 10U;
+                    hd--;
+                }
+                if (   (hmap_add(next, value / split, count) == NULL)
+                    || (hmap_add(next, value % split, count) == NULL))
+                    return 0;
+            }
+            else
+            {
+                if (hmap_add(next, value * 2024U, count) == NULL)
+                    return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
 int
 main(int argc, char** argv)
 {
@@ -48,59 +94,36 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    dll_node_t* head = NULL;
-    node_payload_t value = 0;
+    hmap_t maps[2];
+    hmap_init(&maps[0], 0U);
+    hmap_init(&maps[1], 0U);
+
+    unsigned long long value = 0;
     while(fscanf(fp, "%llu", &value) == 1)
-        dll_add_node(&head, value);
+        hmap_add(&maps[0], value, 1U);
 
     fclose(fp);
 
     for (size_t i = 0U; i < BLINKS; i++)
     {
-        dll_node_t* current = head;
-        while (current != NULL)
+        if (!blink(&maps[i % 2U], &maps[(i + 1U) % 2U]))
         {
-            dll_node_t* next = current->next;
-            if (current->data == 0U)
-            {
-                current->data = 1U;
-            }
-            else
-            {
-                node_payload_t digits = count_digits(current->data);
-                if ((digits % 2U) == 0U)
-                {
-                    node_payload_t new_data = current->data;
-                    node_payload_t split = 10U;
-                    node_payload_t hd = digits / 2U;
-                    while (hd > 1U)
-                    {
-                        split *= 10U;
-                        hd--;
-                    }
-                    current->data /= split;
-                    new_data %= split;
-                    dll_add_node_after(current, new_data);
-                }
-                else
-                {
-                    current->data *= 2024U;
-                }
-            }
-            current = next;
+            fprintf(stderr, "Buy more RAM!\n");
+            hmap_free(&maps[0]);
+            hmap_free(&maps[1]);
+            exit(EXIT_FAILURE);
         }
     }
 
-    dll_node_t* current = head;
-    size_t count = 0U;
-    while (current != NULL)
-    {
-        current = current->next;
-        count++;
-    }
-    printf("Part 1: Stones after %d blinks = %zu\n", BLINKS, count);
+    size_t it = 0U;
+    uint64_t count;
+    size_t stones = 0U;
+    while (hmap_next(&maps[BLINKS % 2U], &it, NULL, &count))
+        stones += count;
+    printf("Part 1: Stones after %d blinks = %zu\n", BLINKS, stones);
 
-    dll_free(head);
+    hmap_free(&maps[0]);
+    hmap_free(&maps[1]);
 
     return EXIT_SUCCESS;
 }
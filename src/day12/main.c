@@ -14,44 +14,6 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-typedef struct
-{
-    int area;
-    int perimeter;
-} data_t;
-
-static void
-walk(grid2d_t* g, size_t y, size_t x, char c, data_t* d)
-{
-    if (g->flags[y][x] > 0U)
-        return;
-
-    g->flags[y][x]++;
-    d->area++;
-
-    if ((y > 0U) && (g->grid[y - 1U][x] == c))
-        walk(g, y - 1U, x, c, d);
-    else
-        d->perimeter++;
-
-    if ((x > 0U) && (g->grid[y][x - 1U] == c))
-        walk(g, y, x - 1U, c, d);
-    else
-        d->perimeter++;
-
-    if ((y < (g->max_y - 1U)) && (g->grid[y + 1U][x] == c))
-        walk(g, y + 1U, x, c, d);
-    else
-        d->perimeter++;
-
-    if ((x < (g->max_x - 1U)) && (g->grid[y][x + 1U] == c))
-        walk(g, y, x + 1U, c, d);
-    else
-        d->perimeter++;
-
-    return;
-}
-
 int
 main(int argc, char** argv)
 {
@@ -63,23 +25,28 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    grid2d_t* g = grid2d_init(argv[1]);
+    grid2d_config_t config = {.options = PLIB_GRID2D_NO_FLAGS};
+    grid2d_t* g = grid2d_init_ex(argv[1], &config);
+    if (g == NULL)
+    {
+        fprintf(stderr, "Input error.\n");
+        exit(EXIT_FAILURE);
+    }
 
-    int count = 0;
-    for (size_t y = 0U; y < g->max_y; y++)
+    grid2d_components_t regions;
+    if (grid2d_components_init(&regions, g, 0U) == NULL)
     {
-        for (size_t x = 0U; x < g->max_x; x++)
-        {
-            if (g->flags[y][x] == 0U)
-            {
-                data_t data = {0};
-                walk(g, y, x, g->grid[y][x], &data);
-                count += data.area * data.perimeter;
-            }
-        }
+        fprintf(stderr, "Memory allocation error.\n");
+        grid2d_free(g);
+        exit(EXIT_FAILURE);
     }
-    printf("Part 1: total price = %d\n", count);
 
+    size_t count = 0U;
+    for (size_t i = 0U; i < regions.num_components; i++)
+        count += regions.area[i] * regions.perimeter[i];
+    printf("Part 1: total price = %zu\n", count);
+
+    grid2d_components_free(&regions);
     grid2d_free(g);
 
     return EXIT_SUCCESS;
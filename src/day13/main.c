@@ -24,16 +24,17 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    flr_t* f = flr_init(*(argv + 1));
+    flr_t* f = flr_init_stream(*(argv + 1), 0U);
 
     size_t i = 0U;
     long x[3];
     long y[3];
     long result = 0;
     const char* p;
-    while((p = flr_get_next_line(f, NULL)) != NULL)
+    size_t length;
+    while((p = flr_get_next_line_ex(f, NULL, &length)) != NULL)
     {
-        if (strlen(p) > 0U)
+        if (length > 0U)
         {
             char c;
             if (i < 2U)
@@ -55,7 +55,7 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    flr_t* f = flr_init(*(argv + 1));
+    flr_t* f = flr_init_ex(*(argv + 1), PLIB_FLR_LAZY);
 
     size_t num_robots = flr_num_lines(f);
     if (num_robots == 0U)
@@ -70,20 +70,21 @@ main(int argc, char** argv)
     }
 
     const char* p;
+    size_t length;
     size_t i = 0U;
-    while((p = flr_get_next_line(f, NULL)) != NULL)
+    while((p = flr_get_next_line_ex(f, NULL, &length)) != NULL)
     {
-        if (sscanf( p,
-                    "p=%d,%d v=%d,%d",
-                    &robots[i].pos.x,
-                    &robots[i].pos.y,
-                    &robots[i].vel.vx,
-                    &robots[i].vel.vy) != 4)
+        long long v[4];
+        if (flr_parse_ints(p, length, v, 4U) != 4U)
         {
             free(robots);
             flr_free(f);
             exit(EXIT_FAILURE);
         }
+        robots[i].pos.x = (int)v[0];
+        robots[i].pos.y = (int)v[1];
+        robots[i].vel.vx = (int)v[2];
+        robots[i].vel.vy = (int)v[3];
         i++;
     }
     flr_free(f);
@@ -11,6 +11,11 @@
 #define PLIB_FLR_NO_NAMESPACE
 #include "plib_flr.h"
 
+#define PLIB_GRID2D_IMPLEMENTATION
+#define PLIB_GRID2D_NO_NAMESPACE
+#define PLIB_GRID2D_FLR
+#include "plib_grid2d.h"
+
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -162,40 +167,23 @@ main(int argc, char** argv)
 
     flr_t* f = flr_init(*(argv + 1));
     const char* p;
-    size_t i = 0U;
     size_t max_x;
-    while (     ((p = flr_get_next_line(f, NULL)) != NULL)
-             && ((max_x = strlen(p)) > 0U))
+    while (     ((p = flr_get_next_line_ex(f, NULL, &max_x)) != NULL)
+             && (max_x > 0U))
     {
         max.y++;
         max.x = max_x;
     }
 
-    grid = malloc(max.y * sizeof(char*));
-    if (grid == NULL)
+    /* warehouse is modified in place, moves follow the empty line */
+    grid2d_config_t config = {.options = PLIB_GRID2D_NO_FLAGS};
+    grid2d_t* g = grid2d_init_flr(f, 1U, max.y, &config);
+    if (g == NULL)
     {
-        free(grid);
+        flr_free(f);
         exit(EXIT_FAILURE);
     }
-
-    for (size_t y = 0U; y < max.y; y++)
-    {
-        grid[y] = malloc(max.x * sizeof(char));
-        if (grid[y] == NULL)
-        {
-            free(grid);
-            exit(EXIT_FAILURE);
-        }
-    }
-
-    flr_reset(f);
-
-    while (    ((p = flr_get_next_line(f, &i)) != NULL)
-            && (strlen(p) > 0U))
-    {
-        assert(i > 0U);
-        memcpy(grid[i - 1U], p, max.x);
-    }
+    grid = g->grid;
 
     coords_t pos = {0};
     for (size_t y = 0U; y < max.y; y++)
@@ -230,10 +218,7 @@ main(int argc, char** argv)
                 result += 100U * y + x;
     printf("Part 1: Sum of GPS coordinates = %zu\n", result);
 
-    for (size_t y = 0U; y < max.y; y++)
-        free(grid[y]);
-    free(grid);
-
+    grid2d_free(g);
     flr_free(f);
 
     return EXIT_SUCCESS;
@@ -0,0 +1,123 @@
+/*
+ * Reindeer maze of day 16 on the plib_grid2d path engine.
+ *
+ * Also included by bench/pq_maze, so the benchmark times the search day 16
+ * runs. The functions are static and plib_grid2d.h is not included here: it
+ * compiles its implementation with the program, so the includer includes it
+ * first (with PLIB_GRID2D_IMPLEMENTATION) and this header after it.
+ *
+ * (C) Copyright 2024 "piscilus" Julian Kraemer
+ *
+ * Distributed under MIT license.
+ * See file LICENSE for details or copy at https://opensource.org/licenses/MIT
+ */
+
+#ifndef REINDEER_H
+#define REINDEER_H
+
+#define REINDEER_SCORE_FWD  (1)
+#define REINDEER_SCORE_TURN (1000)
+
+typedef struct
+{
+    int best;     /* lowest score from start to end, -1 if unreachable */
+    size_t tiles; /* tiles on any best path */
+} reindeer_result_t;
+
+/* Score of turning, up, down and left, right differ in bit 0 */
+static int
+reindeer_turn_score(unsigned int from_dir, unsigned int to_dir)
+{
+    if (from_dir == to_dir)
+        return 0;
+
+    return ((from_dir ^ to_dir) == 1U) ? 2 * REINDEER_SCORE_TURN : REINDEER_SCORE_TURN;
+}
+
+/* Score of a step: turning and moving forward combined */
+static int
+reindeer_step_score(const plib_grid2d_t* g, size_t from, unsigned int from_dir,
+                    size_t to, unsigned int to_dir, void* ctx)
+{
+    (void)g;
+    (void)from;
+    (void)to;
+    (void)ctx;
+
+    return REINDEER_SCORE_FWD + reindeer_turn_score(from_dir, to_dir);
+}
+
+/*
+ * A tile is on a best path if the score of entering it with heading d from the
+ * start, turning to heading e and the score of walking from the end back to it
+ * (entering it against heading e) add up to the best score.
+ */
+static int
+reindeer_on_best_path(const plib_grid2d_path_t* from_start,
+                      const plib_grid2d_path_t* from_end, size_t i, int best)
+{
+    for (unsigned int d = 0U; d < 4U; d++)
+    {
+        int s = plib_grid2d_path_cost_heading(from_start, i, d);
+        if ((s < 0) || (s > best))
+            continue;
+        for (unsigned int e = 0U; e < 4U; e++)
+        {
+            int t = plib_grid2d_path_cost_heading(from_end, i, e ^ 1U);
+            if ((t >= 0) && (s + reindeer_turn_score(d, e) + t == best))
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Lowest score from start (facing east) to end and the number of tiles on any
+ * best path. Walls must be the sentinel of g, queue is the kind of plib_pq.
+ * Returns NULL if out of memory.
+ */
+static reindeer_result_t*
+reindeer_solve(const plib_grid2d_t* g, size_t start, size_t end, int queue,
+               reindeer_result_t* r)
+{
+    plib_grid2d_path_config_t config =
+    {
+        .headings = 1,
+        .cost = reindeer_step_score,
+        .queue = queue,
+        .max_step = REINDEER_SCORE_FWD + 2 * REINDEER_SCORE_TURN
+    };
+
+    /* one search from the start, one from the end, the maze is the same both ways */
+    plib_grid2d_path_t from_start;
+    plib_grid2d_path_t from_end;
+    if (plib_grid2d_path_init(&from_start, g, &config) == NULL)
+        return NULL;
+    if (plib_grid2d_path_init(&from_end, g, &config) == NULL)
+    {
+        plib_grid2d_path_free(&from_start);
+        return NULL;
+    }
+
+    const unsigned int east = PLIB_GRID2D_RIGHT;
+    const unsigned int headings[4] = {PLIB_GRID2D_UP, PLIB_GRID2D_DOWN, PLIB_GRID2D_LEFT, PLIB_GRID2D_RIGHT};
+    const size_t ends[4] = {end, end, end, end};
+    reindeer_result_t* result = NULL;
+    if (   (plib_grid2d_path_run(&from_start, &start, &east, 1U, PLIB_GRID2D_NO_TARGET) != -2)
+        && (plib_grid2d_path_run(&from_end, ends, headings, 4U, PLIB_GRID2D_NO_TARGET) != -2))
+    {
+        r->best = plib_grid2d_path_cost(&from_start, end);
+        r->tiles = 0U;
+        for (size_t i = 0U; (i < g->num_cells) && (r->best >= 0); i++)
+            r->tiles += (size_t)reindeer_on_best_path(&from_start, &from_end, i, r->best);
+        result = r;
+    }
+
+    plib_grid2d_path_free(&from_start);
+    plib_grid2d_path_free(&from_end);
+
+    return result;
+}
+
+#endif /* REINDEER_H */
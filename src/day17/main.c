@@ -75,11 +75,12 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    flr_t* f = flr_init(*(argv + 1));
+    flr_t* f = flr_init_ex(*(argv + 1), PLIB_FLR_LAZY);
     const char* p;
+    size_t length;
 
     int i = 0;
-    while (((p = flr_get_next_line(f, NULL)) != NULL) && (strlen(p) > 0U))
+    while (((p = flr_get_next_line_ex(f, NULL, &length)) != NULL) && (length > 0U))
     {
         if (i >= NUM_REGS)
         {
@@ -95,7 +96,7 @@ main(int argc, char** argv)
         i++;
     }
 
-    if ((p = flr_get_next_line(f, NULL)) == NULL)
+    if ((p = flr_get_next_line_ex(f, NULL, &length)) == NULL)
     {
         fprintf(stderr, "Unexpected end of input\n");
         goto ep;
@@ -110,7 +111,7 @@ main(int argc, char** argv)
     }
 
     const char* prog = p + prefix_len;
-    size_t prog_len = strlen(prog);
+    size_t prog_len = length - prefix_len;
 
     char* parsebuf;
     if ((parsebuf = malloc(sizeof(char) * prog_len)) == NULL)
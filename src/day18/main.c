@@ -11,8 +11,11 @@
 #define PLIB_FLR_NO_NAMESPACE
 #include "plib_flr.h"
 
+#define PLIB_GRID2D_IMPLEMENTATION
+#define PLIB_GRID2D_NO_NAMESPACE
+#include "plib_grid2d.h"
+
 #include <assert.h>
-#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -28,103 +31,6 @@
 #define GRID_SIZE_X (TARGET_X + 1)
 #define GRID_SIZE_Y (TARGET_Y + 1)
 
-typedef struct
-{
-    int x;
-    int y;
-} coords_t;
-
-                /* up   down  left  right */
-const int dy[] = { -1,  1,     0,   0     };
-const int dx[] = {  0,  0,    -1,   1     };
-
-typedef struct
-{
-    coords_t coords;
-    int dist;
-} pos_t;
-
-typedef struct
-{
-    pos_t pos[GRID_SIZE_Y * GRID_SIZE_X];
-    int front;
-    int rear;
-} queue_t;
-
-static void
-queue_init(queue_t* q)
-{
-    q->front = 0;
-    q->rear = 0;
-}
-
-static bool
-queue_is_empty(queue_t* q)
-{
-    return (q->front == q->rear);
-}
-
-static void
-queue_enqueue(queue_t* q, pos_t p)
-{
-    q->pos[q->rear++] = p;
-}
-
-static pos_t
-queue_dequeue(queue_t* q)
-{
-    return q->pos[q->front++];
-}
-
-static bool
-can_enter_field(coords_t c, int g[GRID_SIZE_Y][GRID_SIZE_X], bool v[GRID_SIZE_Y][GRID_SIZE_X])
-{
-    return (   (c.y >= 0)
-            && (c.y < GRID_SIZE_Y)
-            && (c.x >= 0)
-            && (c.x < GRID_SIZE_X)
-            && (g[c.y][c.x] == 0)
-            && !v[c.y][c.x]);
-}
-
-static int
-shortest_path(int grid[GRID_SIZE_Y][GRID_SIZE_X], pos_t start, pos_t end)
-{
-    bool visited[GRID_SIZE_Y][GRID_SIZE_X] = {false};
-
-    queue_t q;
-    queue_init(&q);
-
-    queue_enqueue(&q, start);
-    visited[start.coords.y][start.coords.x] = true;
-
-    while (!queue_is_empty(&q))
-    {
-        pos_t pos = queue_dequeue(&q);
-
-        if (   pos.coords.y == end.coords.y
-            && pos.coords.x == end.coords.x)
-            return pos.dist;
-
-        for (int i = 0; i < 4; i++)
-        {
-            coords_t n =
-            {
-                .y = pos.coords.y + dy[i],
-                .x = pos.coords.x + dx[i]
-            };
-
-            if (can_enter_field(n, grid, visited))
-            {
-                visited[n.y][n.x] = true;
-                queue_enqueue(&q, (pos_t){.coords = n, .dist = pos.dist + 1});
-            }
-        }
-    }
-
-    return -1;
-}
-
 int
 main(int argc, char** argv)
 {
@@ -136,35 +42,46 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    flr_t* f = flr_init(*(argv + 1));
+    flr_t* f = flr_init_ex(*(argv + 1), PLIB_FLR_LAZY);
 
-    pos_t start = {.coords.x = 0, .coords.y = 0, .dist = 0};
-    pos_t end = {.coords.x = TARGET_X, .coords.y = TARGET_Y, .dist = 0};
+    /* corrupted memory is a wall, like the border */
+    grid2d_config_t config = {.options = PLIB_GRID2D_NO_FLAGS, .border = 1U, .sentinel = '#'};
+    grid2d_t* g = grid2d_init_empty(GRID_SIZE_X, GRID_SIZE_Y, '.', &config);
+    grid2d_path_t path;
+    if ((g == NULL) || (grid2d_path_init(&path, g, NULL) == NULL))
+    {
+        fprintf(stderr, "Memory allocation error.\n");
+        exit(EXIT_FAILURE);
+    }
 
-    int grid[GRID_SIZE_Y][GRID_SIZE_X] = {0};
+    size_t start = PLIB_GRID2D_INDEX(g, 0U, 0U);
+    size_t end = PLIB_GRID2D_INDEX(g, (size_t)TARGET_Y, (size_t)TARGET_X);
 
     const char* p;
+    size_t length;
     int i = 0;
-    while ((p = flr_get_next_line(f, NULL)) != NULL)
+    while ((p = flr_get_next_line_ex(f, NULL, &length)) != NULL)
     {
-        int y, x;
-        if (sscanf(p, "%d,%d", &x, &y) != 2)
+        long long v[2];
+        if (flr_parse_ints(p, length, v, 2U) != 2U)
         {
             fprintf(stderr, "Failed to parse line %d: '%s'\n", i, p);
             break;
         }
+        int x = (int)v[0];
+        int y = (int)v[1];
         assert(y < GRID_SIZE_Y);
         assert(x < GRID_SIZE_X);
-        grid[y][x] = 1;
+        g->grid[y][x] = '#';
         i++;
         if (i == STEPS)
         {
-            int result = shortest_path(grid, start, end);
+            int result = grid2d_path_run(&path, &start, NULL, 1U, end);
             printf("Part 1: minimum number of steps = %d\n", result);
         }
         else if (i > STEPS)
         {
-            int result = shortest_path(grid, start, end);
+            int result = grid2d_path_run(&path, &start, NULL, 1U, end);
             if (result < 0)
             {
                 printf("Part 2: unreachable after %d steps, pos = %d,%d\n", i, x, y);
@@ -178,12 +95,14 @@ main(int argc, char** argv)
     {
         for (int x = 0; x < GRID_SIZE_X; x++)
         {
-            printf("%d", grid[y][x]);
+            putchar(g->grid[y][x]);
         }
         putchar('\n');
     }
 #endif
 
+    grid2d_path_free(&path);
+    grid2d_free(g);
     flr_free(f);
 
     return EXIT_SUCCESS;
@@ -45,7 +45,7 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    flr_t* f = flr_init(*(argv + 1));
+    flr_t* f = flr_init_stream_ex(*(argv + 1), 0U, PLIB_FLR_PREFETCH);
 
     unsigned long result = 0U;
     const char* p;
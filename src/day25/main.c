@@ -7,6 +7,10 @@
  * See file LICENSE for details or copy at https://opensource.org/licenses/MIT
  */
 
+#define PLIB_ARENA_IMPLEMENTATION
+#define PLIB_ARENA_NO_NAMESPACE
+#include "plib_arena.h"
+
 #define PLIB_FLR_IMPLEMENTATION
 #define PLIB_FLR_NO_NAMESPACE
 #include "plib_flr.h"
@@ -36,25 +40,35 @@ main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    flr_t* f = flr_init(*(argv + 1));
+    flr_t* f = flr_init_ex(*(argv + 1), PLIB_FLR_LAZY);
     if (f == NULL)
     {
         fprintf(stderr, "Input corrupted\n");
         goto ep2;
     }
 
-    keylock_t* keys = NULL;
-    keylock_t* locks = NULL;
+    /* each schematic takes a line at least and a separator, whatever its height */
+    size_t max_schematics = (flr_num_lines(f) + 1U) / 2U + 1U;
+    arena_t arena;
+    arena_init(&arena, 0U, 0U);
+    keylock_t* keys = arena_alloc(&arena, max_schematics * sizeof(keylock_t));
+    keylock_t* locks = arena_alloc(&arena, max_schematics * sizeof(keylock_t));
     int num_keys = 0;
     int num_locks = 0;
+    if ((keys == NULL) || (locks == NULL))
+    {
+        fprintf(stderr, "Buy more RAM\n");
+        goto ep;
+    }
 
     keylock_t* current;
 
     int i = 0;
     const char* p;
-    while ((p = flr_get_next_line(f, NULL)) != NULL)
+    size_t length;
+    while ((p = flr_get_next_line_ex(f, NULL, &length)) != NULL)
     {
-        if (strlen(p) == 0U)
+        if (length == 0U)
         {
             i = 0;
             continue;
@@ -63,24 +77,14 @@ main(int argc, char** argv)
         {
             if (p[0] == '#') /* lock */
             {
-                locks = realloc(locks, (num_locks + 1) * sizeof(keylock_t));
-                if (locks == NULL)
-                {
-                    fprintf(stderr, "Buy more RAM\n");
-                    goto ep;
-                }
+                assert((size_t)num_locks < max_schematics);
                 current = &locks[num_locks];
                 memset(current, 0, sizeof(keylock_t));
                 num_locks++;
             }
             else /* '.'  = key */
             {
-                keys = realloc(keys, (num_keys + 1) * sizeof(keylock_t));
-                if (keys == NULL)
-                {
-                    fprintf(stderr, "Buy more RAM\n");
-                    goto ep;
-                }
+                assert((size_t)num_keys < max_schematics);
                 current = &keys[num_keys];
                 memset(current, 0, sizeof(keylock_t));
                 num_keys++;
@@ -88,8 +92,8 @@ main(int argc, char** argv)
         }
         else
         {
-            assert(strlen(p) == WIDTH);
-            for (size_t j = 0U; j < WIDTH; j++)
+            assert(length == WIDTH);
+            for (size_t j = 0U; (j < WIDTH) && (j < length); j++)
             if (p[j] == '#')
                 current->bitting[j]++;
         }
@@ -116,10 +120,7 @@ main(int argc, char** argv)
 
     ep:
 
-    if (keys != NULL)
-        free(keys);
-    if (locks != NULL)
-        free(locks);
+    arena_free(&arena);
     flr_free(f);
 
     ep2:
@@ -7,9 +7,11 @@ CC = gcc
 CFLAGS =\
 	-c -std=c23\
 	-Wall -Wextra -Wpedantic\
-	-MMD
+	-MMD\
+	-pthread
 LDFLAGS =\
-	-lm
+	-lm\
+	-pthread
 ifdef DEBUG
 	DIR_OBJ = $(DIR_BUILD)/debug
 	CFLAGS +=\
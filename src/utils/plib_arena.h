@@ -0,0 +1,447 @@
+/*
+ * plib_arena - v0.1.0 - Arena Allocator.
+ *
+ * The arena hands out memory by bumping a pointer through large blocks. Single
+ * allocations are never freed, all memory is released at once (plib_arena_free)
+ * or recycled for new allocations (plib_arena_reset, plib_arena_release).
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2024 "piscilus" Julian Kraemer
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *
+ * Notes
+ *
+ * Allocations are aligned to PLIB_ARENA_ALIGN (max_align_t). When the current
+ * block is exhausted a new one is taken, its size doubles up to
+ * PLIB_ARENA_MAX_BLOCK (larger requests get a block of their own). Blocks are
+ * kept until plib_arena_free, so a loop which resets the arena allocates no
+ * more memory after the first iterations.
+ *
+ * plib_arena_mark remembers the current position, plib_arena_release discards
+ * everything allocated after it, e.g. the temporary data of one line of input.
+ * plib_arena_resize grows the last allocation in place if possible.
+ *
+ * With option PLIB_ARENA_HUGE_PAGES blocks are anonymous mappings, rounded up
+ * to PLIB_ARENA_HUGE_PAGE_SIZE and advised to be backed by transparent huge
+ * pages (POSIX only, ignored elsewhere).
+ *
+ * An arena must not be used by several threads at the same time.
+ *
+ * Unlike the other headers the implementation is only compiled with
+ * PLIB_ARENA_IMPLEMENTATION defined, so the arena can be shared by several
+ * translation units.
+ *
+ *
+ * Version History
+ *
+ * 0.1.0 (2026-10-17) First release
+ *
+ */
+
+#ifndef PLIB_ARENA_H
+#define PLIB_ARENA_H
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS, madvise */
+#endif
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PLIB_ARENA_HAS_MMAP
+#include <sys/mman.h>
+#endif
+
+#ifdef PBLIB_ARENA_STATIC
+#define PBLIB_ARENA_DEF static
+#else
+#define PBLIB_ARENA_DEF extern
+#endif
+
+/* Options for plib_arena_init */
+#define PLIB_ARENA_HUGE_PAGES (1U << 0U) /* back blocks by huge pages */
+
+#ifndef PLIB_ARENA_ALIGN
+#define PLIB_ARENA_ALIGN (_Alignof(max_align_t))
+#endif
+
+/* Size of first block if 0 is passed to plib_arena_init */
+#ifndef PLIB_ARENA_BLOCK_SIZE
+#define PLIB_ARENA_BLOCK_SIZE (1U << 16U)
+#endif
+
+#ifndef PLIB_ARENA_MAX_BLOCK
+#define PLIB_ARENA_MAX_BLOCK (1U << 26U)
+#endif
+
+#ifndef PLIB_ARENA_HUGE_PAGE_SIZE
+#define PLIB_ARENA_HUGE_PAGE_SIZE (1U << 21U)
+#endif
+
+typedef struct plib_arena_block plib_arena_block_t;
+
+typedef struct
+{
+    plib_arena_block_t* block; /* current block, NULL before first allocation */
+    char* pos;                 /* next free byte of current block */
+    char* end;
+    char* last;                /* last allocation, for plib_arena_resize */
+    size_t block_size;         /* size of next block */
+    unsigned int options;
+} plib_arena_t;
+
+/* Position in an arena */
+typedef struct
+{
+    plib_arena_block_t* block;
+    char* pos;
+} plib_arena_mark_t;
+
+/* Initialize with size of first block (0: default) and options PLIB_ARENA_... */
+PBLIB_ARENA_DEF plib_arena_t*
+plib_arena_init(plib_arena_t* a, size_t block_size, unsigned int options);
+
+/* Allocate from a new block, used by plib_arena_alloc */
+PBLIB_ARENA_DEF void*
+plib_arena_alloc_slow(plib_arena_t* a, size_t size);
+
+/* Allocate size bytes, NULL if out of memory */
+static inline void*
+plib_arena_alloc(plib_arena_t* a, size_t size)
+{
+    size_t aligned = (size + PLIB_ARENA_ALIGN - 1U) & ~(size_t)(PLIB_ARENA_ALIGN - 1U);
+    if ((aligned >= size) && (aligned < (size_t)(a->end - a->pos)))
+    {
+        a->last = a->pos;
+        a->pos += aligned;
+        return a->last;
+    }
+
+    return plib_arena_alloc_slow(a, size);
+}
+
+/* Allocate n zeroed elements of size bytes */
+PBLIB_ARENA_DEF void*
+plib_arena_calloc(plib_arena_t* a, size_t n, size_t size);
+
+/*
+ * Resize allocation p of old_size bytes, in place if it is the last one and
+ * the block has room, else by copying. Returns new location, NULL if out of
+ * memory (p stays valid).
+ */
+PBLIB_ARENA_DEF void*
+plib_arena_resize(plib_arena_t* a, void* p, size_t old_size, size_t new_size);
+
+/* Copy null-terminated string s */
+PBLIB_ARENA_DEF char*
+plib_arena_strdup(plib_arena_t* a, const char* s);
+
+/* Copy length characters of s and null-terminate */
+PBLIB_ARENA_DEF char*
+plib_arena_strndup(plib_arena_t* a, const char* s, size_t length);
+
+/* Get current position */
+PBLIB_ARENA_DEF plib_arena_mark_t
+plib_arena_mark(const plib_arena_t* a);
+
+/* Discard all allocations after mark, blocks are kept */
+PBLIB_ARENA_DEF void
+plib_arena_release(plib_arena_t* a, plib_arena_mark_t mark);
+
+/* Discard all allocations, blocks are kept */
+PBLIB_ARENA_DEF void
+plib_arena_reset(plib_arena_t* a);
+
+/* Free all blocks */
+PBLIB_ARENA_DEF void
+plib_arena_free(plib_arena_t* a);
+
+#endif /* PLIB_ARENA_H */
+
+#if defined(PLIB_ARENA_IMPLEMENTATION) && !defined(PLIB_ARENA_IMPLEMENTATION_DONE_)
+#define PLIB_ARENA_IMPLEMENTATION_DONE_
+
+struct plib_arena_block
+{
+    plib_arena_block_t* prev; /* previously used block */
+    plib_arena_block_t* next; /* kept for reuse after release/reset */
+    size_t size;              /* incl. this header */
+    int mapped;
+};
+
+/* header size, keeps allocations aligned */
+#define PLIB_ARENA_HEADER \
+    ((sizeof(plib_arena_block_t) + PLIB_ARENA_ALIGN - 1U) & ~(size_t)(PLIB_ARENA_ALIGN - 1U))
+
+static plib_arena_block_t*
+plib_arena_new_block(plib_arena_t* a, size_t size)
+{
+    plib_arena_block_t* b = NULL;
+    int mapped = 0;
+#ifdef PLIB_ARENA_HAS_MMAP
+    if (a->options & PLIB_ARENA_HUGE_PAGES)
+    {
+        size = (size + PLIB_ARENA_HUGE_PAGE_SIZE - 1U) & ~(size_t)(PLIB_ARENA_HUGE_PAGE_SIZE - 1U);
+        void* p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            return NULL;
+#ifdef MADV_HUGEPAGE
+        madvise(p, size, MADV_HUGEPAGE);
+#endif
+        b = p;
+        mapped = 1;
+    }
+#endif
+    if (!mapped)
+    {
+        b = malloc(size);
+        if (b == NULL)
+            return NULL;
+    }
+
+    b->prev = NULL;
+    b->next = NULL;
+    b->size = size;
+    b->mapped = mapped;
+
+    return b;
+}
+
+static void
+plib_arena_free_block(plib_arena_block_t* b)
+{
+#ifdef PLIB_ARENA_HAS_MMAP
+    if (b->mapped)
+    {
+        munmap(b, b->size);
+        return;
+    }
+#endif
+    free(b);
+}
+
+/* Make b (following the current block) the current block */
+static void
+plib_arena_enter(plib_arena_t* a, plib_arena_block_t* b)
+{
+    b->prev = a->block;
+    a->block = b;
+    a->pos = (char*)b + PLIB_ARENA_HEADER;
+    a->end = (char*)b + b->size;
+}
+
+PBLIB_ARENA_DEF plib_arena_t*
+plib_arena_init(plib_arena_t* a, size_t block_size, unsigned int options)
+{
+    if (a == NULL)
+        return NULL;
+
+    a->block = NULL;
+    a->pos = NULL;
+    a->end = NULL;
+    a->last = NULL;
+    a->block_size = (block_size > 0U) ? block_size : PLIB_ARENA_BLOCK_SIZE;
+    a->options = options;
+
+    return a;
+}
+
+PBLIB_ARENA_DEF void*
+plib_arena_alloc_slow(plib_arena_t* a, size_t size)
+{
+    size_t aligned = (size + PLIB_ARENA_ALIGN - 1U) & ~(size_t)(PLIB_ARENA_ALIGN - 1U);
+    if ((aligned < size) || (aligned > SIZE_MAX - PLIB_ARENA_HEADER))
+        return NULL;
+    size_t needed = aligned + PLIB_ARENA_HEADER;
+
+    /* blocks kept by release/reset first, too small ones are skipped */
+    plib_arena_block_t* spare = (a->block != NULL) ? a->block->next : NULL;
+    while ((spare != NULL) && (spare->size < needed))
+    {
+        plib_arena_block_t* next = spare->next;
+        if (a->block != NULL)
+            a->block->next = next;
+        plib_arena_free_block(spare);
+        spare = next;
+    }
+
+    if (spare == NULL)
+    {
+        size_t block_size = (a->block_size > needed) ? a->block_size : needed;
+        spare = plib_arena_new_block(a, block_size);
+        if (spare == NULL)
+            return NULL;
+        if (a->block_size < PLIB_ARENA_MAX_BLOCK)
+            a->block_size *= 2U;
+        if (a->block != NULL)
+            a->block->next = spare;
+    }
+    plib_arena_enter(a, spare);
+
+    a->last = a->pos;
+    a->pos += aligned;
+
+    return a->last;
+}
+
+PBLIB_ARENA_DEF void*
+plib_arena_calloc(plib_arena_t* a, size_t n, size_t size)
+{
+    if ((size > 0U) && (n > SIZE_MAX / size))
+        return NULL;
+
+    void* p = plib_arena_alloc(a, n * size);
+    if (p != NULL)
+        memset(p, 0, n * size);
+
+    return p;
+}
+
+PBLIB_ARENA_DEF void*
+plib_arena_resize(plib_arena_t* a, void* p, size_t old_size, size_t new_size)
+{
+    if (p == NULL)
+        return plib_arena_alloc(a, new_size);
+
+    if (p == a->last)
+    {
+        size_t aligned = (new_size + PLIB_ARENA_ALIGN - 1U) & ~(size_t)(PLIB_ARENA_ALIGN - 1U);
+        if ((aligned >= new_size) && (aligned <= (size_t)(a->end - a->last)))
+        {
+            a->pos = a->last + aligned;
+            return p;
+        }
+    }
+
+    if (new_size <= old_size)
+        return p;
+
+    void* q = plib_arena_alloc(a, new_size);
+    if (q != NULL)
+        memcpy(q, p, old_size);
+
+    return q;
+}
+
+PBLIB_ARENA_DEF char*
+plib_arena_strndup(plib_arena_t* a, const char* s, size_t length)
+{
+    char* d = plib_arena_alloc(a, length + 1U);
+    if (d != NULL)
+    {
+        memcpy(d, s, length);
+        d[length] = '\0';
+    }
+
+    return d;
+}
+
+PBLIB_ARENA_DEF char*
+plib_arena_strdup(plib_arena_t* a, const char* s)
+{
+    return plib_arena_strndup(a, s, strlen(s));
+}
+
+PBLIB_ARENA_DEF plib_arena_mark_t
+plib_arena_mark(const plib_arena_t* a)
+{
+    return (plib_arena_mark_t){.block = a->block, .pos = a->pos};
+}
+
+PBLIB_ARENA_DEF void
+plib_arena_release(plib_arena_t* a, plib_arena_mark_t mark)
+{
+    if (mark.block == NULL)
+    {
+        plib_arena_reset(a);
+        return;
+    }
+
+    /* blocks entered after the mark stay linked as spares behind it */
+    while (a->block != mark.block)
+        a->block = a->block->prev;
+    a->pos = mark.pos;
+    a->end = (char*)a->block + a->block->size;
+    a->last = NULL;
+}
+
+PBLIB_ARENA_DEF void
+plib_arena_reset(plib_arena_t* a)
+{
+    if (a->block == NULL)
+        return;
+
+    while (a->block->prev != NULL)
+        a->block = a->block->prev;
+    a->pos = (char*)a->block + PLIB_ARENA_HEADER;
+    a->end = (char*)a->block + a->block->size;
+    a->last = NULL;
+}
+
+PBLIB_ARENA_DEF void
+plib_arena_free(plib_arena_t* a)
+{
+    if (a->block == NULL)
+        return;
+
+    plib_arena_reset(a);
+    plib_arena_block_t* b = a->block;
+    while (b != NULL)
+    {
+        plib_arena_block_t* next = b->next;
+        plib_arena_free_block(b);
+        b = next;
+    }
+    a->block = NULL;
+    a->pos = NULL;
+    a->end = NULL;
+}
+#endif /* PLIB_ARENA_IMPLEMENTATION */
+
+#ifndef PLIB_ARENA_NO_NAMESPACE_GUARD_
+#define PLIB_ARENA_NO_NAMESPACE_GUARD_
+#ifdef PLIB_ARENA_NO_NAMESPACE
+    #define arena_t plib_arena_t
+    #define arena_mark_t plib_arena_mark_t
+    #define arena_init plib_arena_init
+    #define arena_alloc plib_arena_alloc
+    #define arena_calloc plib_arena_calloc
+    #define arena_resize plib_arena_resize
+    #define arena_strdup plib_arena_strdup
+    #define arena_strndup plib_arena_strndup
+    #define arena_mark plib_arena_mark
+    #define arena_release plib_arena_release
+    #define arena_reset plib_arena_reset
+    #define arena_free plib_arena_free
+#endif /* PLIB_ARENA_NO_NAMESPACE */
+#endif /* PLIB_ARENA_NO_NAMESPACE_GUARD_ */
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 "piscilus" Julian Kraemer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
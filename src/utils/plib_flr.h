@@ -1,9 +1,13 @@
 /*
- * plib_flr - v0.1.0 - File Line Reader.
+ * plib_flr - v0.10.0 - File Line Reader.
  *
  * The FLR read contents from a file into memory and allows access to
  * null-terminated lines.
  *
+ * Alternatively the file can be memory-mapped (see plib_flr_init_ex). In this
+ * mode the file content is neither copied nor modified, lines are accessed as
+ * views (pointer and length) into the mapping.
+ *
  * SPDX-FileCopyrightText: Copyright (c) 2024 "piscilus" Julian Kraemer
  *
  * SPDX-License-Identifier: MIT
@@ -13,45 +17,224 @@
  *
  * Only UNIX end-of-line (line-feed) supported!
  *
+ * Lines are indexed in a single pass, vectorized with SSE2 or AVX2 (selected at
+ * runtime) on x86 with GCC/Clang, otherwise based on memchr. With option
+ * PLIB_FLR_PARALLEL large files are split into ranges which are indexed by
+ * one thread each (POSIX threads, link with -pthread).
+ *
+ * With option PLIB_FLR_LAZY no index is built at load time, the iterators find
+ * the next line on demand. The index is built on first random access
+ * (plib_flr_get_line, plib_flr_get_view, plib_flr_reset) or when the longest
+ * line is queried. plib_flr_num_lines counts the lines without building it.
+ *
+ * With option PLIB_FLR_SIDECAR the line index is stored next to the file (file
+ * path + PLIB_FLR_SIDECAR_SUFFIX) as line offsets, keyed by size and
+ * modification time of the file. Later runs map the sidecar instead of
+ * indexing, lines are terminated on access then (POSIX only). The offsets are
+ * checked when loaded (ascending, within the file, each line after an
+ * end-of-line), otherwise the file is indexed as without sidecar.
+ *
+ * Input which cannot be seeked (pipes, stdin as file path "-" or a file
+ * descriptor passed to plib_flr_init_fd) is read until end of file into a
+ * growing buffer, lines are indexed while the data arrives (POSIX only).
+ *
+ * Streaming mode (see plib_flr_init_stream) reads the file in chunks of fixed
+ * size instead of loading it completely, so memory usage is bounded by the
+ * chunk size (or the longest line, if larger). Lines are only valid until the
+ * next call of an accessor, random access via plib_flr_get_line and
+ * plib_flr_get_view is not supported and plib_flr_num_lines returns the number
+ * of lines read so far. With option PLIB_FLR_PREFETCH (plib_flr_init_stream_ex)
+ * a reader thread keeps PLIB_FLR_PREFETCH_SLOTS chunks in flight, so reading
+ * the next chunks overlaps with processing the current one. Lines are taken
+ * from the chunks in place, only a line straddling two chunks is copied.
+ *
+ * The cursor functions (plib_flr_cursor_init, plib_flr_next_int, ...) extract
+ * decimal integers from a line, any other character is a separator. A '-'
+ * directly in front of a digit is a sign. They neither allocate nor depend on
+ * the locale, overflow is not detected.
+ *
+ * Memory-mapped mode requires a POSIX system. The null-terminated accessors
+ * plib_flr_get_next_line and plib_flr_get_line return NULL in this mode, use
+ * plib_flr_get_next_view and plib_flr_get_view instead.
+ *
+ * The implementation is compiled once per translation unit, the header can be
+ * included again (e.g. by plib_grid2d.h).
+ *
  *
  * Version History
  *
  * 0.1.0 (2024-11-11) First public release
+ * 0.2.0 (2026-10-17) Memory-mapped loading and line views
+ * 0.2.1 (2026-10-17) Single-pass vectorized line indexing
+ * 0.3.0 (2026-10-17) Streaming mode with bounded memory
+ * 0.3.1 (2026-10-17) Line length in iterator, max line length
+ * 0.4.0 (2026-10-17) Numeric field tokenizer
+ * 0.5.0 (2026-10-17) Multi-threaded line indexing
+ * 0.6.0 (2026-10-17) Loading from file descriptors, pipes and stdin
+ * 0.7.0 (2026-10-17) Prefetching reader thread for streaming mode
+ * 0.8.0 (2026-10-17) Lazy line index
+ * 0.9.0 (2026-10-17) Persistent line index sidecar files
+ * 0.10.0 (2026-10-17) Views of line ranges, mapping query
  *
  */
 
 #ifndef PLIB_FLR_H
 #define PLIB_FLR_H
 
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE /* MAP_POPULATE, madvise */
+#endif
+
 #include <assert.h>
+#include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#define PLIB_FLR_HAS_FD
+#define PLIB_FLR_HAS_MMAP
+#define PLIB_FLR_HAS_THREADS
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define PLIB_FLR_HAS_SWAR 1
+#else
+#define PLIB_FLR_HAS_SWAR 0
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define PLIB_FLR_HAS_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define PLIB_FLR_HAS_X86_SIMD 0
+#endif
+
 #ifdef PBLIB_FLR_STATIC
 #define PBLIB_FLR_DEF static
 #else
 #define PBLIB_FLR_DEF extern
 #endif
 
+/* Options for plib_flr_init_ex */
+#define PLIB_FLR_MMAP       (1U << 0U) /* map file read-only, zero-copy */
+#define PLIB_FLR_POPULATE   (1U << 1U) /* prefault the mapping */
+#define PLIB_FLR_SEQUENTIAL (1U << 2U) /* advise sequential access */
+#define PLIB_FLR_PARALLEL   (1U << 3U) /* index lines multi-threaded */
+#define PLIB_FLR_PREFETCH   (1U << 4U) /* streaming: read ahead in a thread */
+#define PLIB_FLR_LAZY       (1U << 5U) /* build line index on demand */
+#define PLIB_FLR_SIDECAR    (1U << 6U) /* reuse line index stored in file */
+
+#ifndef PLIB_FLR_SIDECAR_SUFFIX
+#define PLIB_FLR_SIDECAR_SUFFIX ".idx"
+#endif
+
+/* Limits for PLIB_FLR_PARALLEL */
+#ifndef PLIB_FLR_MAX_THREADS
+#define PLIB_FLR_MAX_THREADS (64U)
+#endif
+#ifndef PLIB_FLR_MIN_RANGE
+#define PLIB_FLR_MIN_RANGE (1U << 22U) /* bytes per thread at least */
+#endif
+
+/* Chunks in flight for PLIB_FLR_PREFETCH */
+#ifndef PLIB_FLR_PREFETCH_SLOTS
+#define PLIB_FLR_PREFETCH_SLOTS (2U)
+#endif
+
+/* Bytes in front of each prefetched chunk for a line continued from the last */
+#ifndef PLIB_FLR_PREFETCH_HEADROOM
+#define PLIB_FLR_PREFETCH_HEADROOM (4096U)
+#endif
+
+/* Default chunk size for plib_flr_init_stream and plib_flr_init_fd */
+#ifndef PLIB_FLR_CHUNK_SIZE
+#define PLIB_FLR_CHUNK_SIZE (1U << 20U)
+#endif
+
 typedef struct plib_flr plib_flr_t;
 
+/* Line as view into the buffer, not null-terminated */
+typedef struct
+{
+    const char* data;
+    size_t length;
+} plib_flr_view_t;
+
+/* Position within a line for extracting numbers */
+typedef struct
+{
+    const char* p;
+    const char* end;
+} plib_flr_cursor_t;
+
 /* Initialize and load from a file */
 PBLIB_FLR_DEF plib_flr_t*
 flr_init(const char* file_path);
 
+/* Initialize and load from a file with options PLIB_FLR_... */
+PBLIB_FLR_DEF plib_flr_t*
+plib_flr_init_ex(const char* file_path, unsigned int options);
+
+/* Initialize and load from a file descriptor until end of file */
+PBLIB_FLR_DEF plib_flr_t*
+plib_flr_init_fd(int fd);
+
+/* Initialize streaming from a file (empty: no lines), chunk_size 0 for default */
+PBLIB_FLR_DEF plib_flr_t*
+plib_flr_init_stream(const char* file_path, size_t chunk_size);
+
+/* Initialize streaming from a file with options PLIB_FLR_... */
+PBLIB_FLR_DEF plib_flr_t*
+plib_flr_init_stream_ex(const char* file_path, size_t chunk_size,
+                        unsigned int options);
+
 /* Get number of lines */
 PBLIB_FLR_DEF size_t
 plib_flr_num_lines(plib_flr_t* flr);
 
+/* Get length of longest line (streaming mode: of lines read so far) */
+PBLIB_FLR_DEF size_t
+plib_flr_max_line_length(plib_flr_t* flr);
+
 /* Get next line and its line number (optional) */
 PBLIB_FLR_DEF const char*
 plib_flr_get_next_line(plib_flr_t* flr, size_t* line);
 
+/* Get next line, its line number (optional) and its length (optional) */
+PBLIB_FLR_DEF const char*
+plib_flr_get_next_line_ex(plib_flr_t* flr, size_t* line, size_t* length);
+
 /* Get specific line */
 PBLIB_FLR_DEF const char*
 plib_flr_get_line(plib_flr_t* flr, size_t line);
 
+/* Get next line as view and its line number (optional) */
+PBLIB_FLR_DEF plib_flr_view_t*
+plib_flr_get_next_view(plib_flr_t* flr, plib_flr_view_t* view, size_t* line);
+
+/* Get specific line as view */
+PBLIB_FLR_DEF plib_flr_view_t*
+plib_flr_get_view(plib_flr_t* flr, size_t line, plib_flr_view_t* view);
+
+/*
+ * Get lines first..first+num_lines-1 as one view (w/out last end-of-line), the
+ * position of the iterator is kept
+ */
+PBLIB_FLR_DEF plib_flr_view_t*
+plib_flr_get_lines_view(plib_flr_t* flr, size_t first, size_t num_lines,
+                        plib_flr_view_t* view);
+
+/* Check if the file is memory-mapped, its content must not be modified then */
+PBLIB_FLR_DEF int
+plib_flr_is_mapped(const plib_flr_t* flr);
+
 /* Reset iterator to first line */
 PBLIB_FLR_DEF void
 plib_flr_reset(plib_flr_t* flr);
@@ -59,12 +242,29 @@ plib_flr_reset(plib_flr_t* flr);
 /* Free memory */
 PBLIB_FLR_DEF void
 plib_flr_free(plib_flr_t* flr);
-#elif
+
+/* Initialize cursor on data of given length */
+PBLIB_FLR_DEF plib_flr_cursor_t*
+plib_flr_cursor_init(plib_flr_cursor_t* c, const char* data, size_t length);
+
+/* Get next signed integer, NULL if there is none */
+PBLIB_FLR_DEF plib_flr_cursor_t*
+plib_flr_next_int(plib_flr_cursor_t* c, long long* value);
+
+/* Get next unsigned integer (sign ignored), NULL if there is none */
+PBLIB_FLR_DEF plib_flr_cursor_t*
+plib_flr_next_uint(plib_flr_cursor_t* c, unsigned long long* value);
+
+/* Get up to max_values signed integers of data, returns number of values */
+PBLIB_FLR_DEF size_t
+plib_flr_parse_ints(const char* data, size_t length, long long* values,
+                    size_t max_values);
 
 #endif /* PLIB_FLR_H */
 
 #define PLIB_FLR_IMPLEMENTATION
-#ifdef PLIB_FLR_IMPLEMENTATION
+#if defined(PLIB_FLR_IMPLEMENTATION) && !defined(PLIB_FLR_IMPLEMENTATION_DONE_)
+#define PLIB_FLR_IMPLEMENTATION_DONE_
 struct plib_flr
 {
     FILE* fp;
@@ -73,8 +273,42 @@ struct plib_flr
     char** lines;      /* list of pointers to line beginnings */
     size_t num_lines;
     size_t current_line;
+    size_t max_length; /* longest line, valid if max_length_known */
+    int max_length_known;
+    int mapped;        /* file_buffer is a read-only mapping */
+    int streaming;     /* file_buffer holds the current chunk only */
+    size_t capacity;   /* streaming: size of file_buffer w/out terminator */
+    size_t fill;       /* streaming: valid bytes in file_buffer */
+    size_t pos;        /* streaming: beginning of next line in file_buffer */
+    int eof;           /* streaming: end of file reached */
+    struct plib_flr_prefetch* prefetch; /* streaming: reader thread or NULL */
+    int lazy;          /* line index not built yet */
+    char* lazy_next;   /* lazy: beginning of next line, NULL at end of file */
+    const uint64_t* offsets; /* line beginnings from sidecar, instead of lines */
+    void* sidecar;     /* mapped sidecar file */
+    size_t sidecar_size;
 };
 
+/* Header of a sidecar file, followed by num_lines line offsets */
+typedef struct
+{
+    uint64_t magic;
+    uint64_t file_size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    uint64_t num_lines;
+} plib_flr_sidecar_t;
+
+#define PLIB_FLR_SIDECAR_MAGIC (0x31584449524c4650ULL) /* "PFLRIDX1" */
+
+/* Growing list of line beginnings, used while indexing */
+typedef struct
+{
+    char** lines;
+    size_t num_lines;
+    size_t capacity;
+} plib_flr_index_t;
+
 static plib_flr_t*
 plib_flr_determine_file_size(plib_flr_t* flr)
 {
@@ -120,156 +354,1539 @@ plib_flr_read_file(plib_flr_t* flr)
     return flr;
 }
 
+#ifdef PLIB_FLR_HAS_MMAP
 static plib_flr_t*
-plib_flr_detect_lines(plib_flr_t* flr)
+plib_flr_map_file(plib_flr_t* flr, unsigned int options)
 {
     assert(flr != NULL);
-    assert(flr->file_buffer != NULL);
-    assert(flr->file_size > 0U);
-
-    flr->num_lines = 0U;
-    for (size_t i = 0U; i < flr->file_size; i++)
-        if (flr->file_buffer[i] == '\n')
-            flr->num_lines++;
+    assert(flr->fp != NULL);
 
-    if (flr->file_buffer[flr->file_size - 1U] != '\n')
-        flr->num_lines++;
+    if (flr->file_size == 0U)
+        return NULL;
 
-    flr->lines = (char**)malloc(flr->num_lines * sizeof(char*));
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (options & PLIB_FLR_POPULATE)
+        flags |= MAP_POPULATE;
+#endif
 
-    if (flr->lines == NULL)
+    void* p = mmap(NULL, flr->file_size, PROT_READ, flags, fileno(flr->fp), 0);
+    if (p == MAP_FAILED)
         return NULL;
 
-    char* current_line = flr->file_buffer;
-    for (size_t i = 0U; i < flr->num_lines; i++)
+    if (options & PLIB_FLR_SEQUENTIAL)
+        (void)madvise(p, flr->file_size, MADV_SEQUENTIAL);
+
+    flr->file_buffer = p;
+    flr->mapped = 1;
+
+    return flr;
+}
+#endif /* PLIB_FLR_HAS_MMAP */
+
+static plib_flr_index_t*
+plib_flr_index_push(plib_flr_index_t* idx, char* line)
+{
+    assert(idx != NULL);
+
+    if (idx->num_lines == idx->capacity)
     {
-        flr->lines[i] = current_line;
-        char* next_line = strchr(current_line, '\n');
-        if (next_line != NULL)
+        size_t capacity = (idx->capacity > 0U) ? idx->capacity * 2U : 1024U;
+        char** lines = realloc(idx->lines, capacity * sizeof(char*));
+        if (lines == NULL)
+            return NULL;
+        idx->lines = lines;
+        idx->capacity = capacity;
+    }
+    idx->lines[idx->num_lines++] = line;
+
+    return idx;
+}
+
+/* Record the beginning of the next line for every EOL in [begin, end) */
+static plib_flr_index_t*
+plib_flr_index_range_scalar(plib_flr_index_t* idx, char* begin, char* end,
+                            int terminate)
+{
+    char* p = begin;
+    while ((p = memchr(p, '\n', (size_t)(end - p))) != NULL)
+    {
+        if (terminate)
+            *p = '\0';
+        if (plib_flr_index_push(idx, ++p) == NULL)
+            return NULL;
+    }
+
+    return idx;
+}
+
+#if PLIB_FLR_HAS_X86_SIMD
+static plib_flr_index_t*
+plib_flr_index_range_sse2(plib_flr_index_t* idx, char* begin, char* end,
+                          int terminate)
+{
+    const __m128i eol = _mm_set1_epi8('\n');
+    char* p = begin;
+    for (; p + 16 <= end; p += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, eol));
+        while (mask != 0U)
         {
-            *next_line = '\0';
-            current_line = next_line + 1;
+            char* q = p + __builtin_ctz(mask);
+            if (terminate)
+                *q = '\0';
+            if (plib_flr_index_push(idx, q + 1) == NULL)
+                return NULL;
+            mask &= mask - 1U;
         }
-        else
+    }
+
+    return plib_flr_index_range_scalar(idx, p, end, terminate);
+}
+
+__attribute__((target("avx2")))
+static plib_flr_index_t*
+plib_flr_index_range_avx2(plib_flr_index_t* idx, char* begin, char* end,
+                          int terminate)
+{
+    const __m256i eol = _mm256_set1_epi8('\n');
+    char* p = begin;
+    for (; p + 32 <= end; p += 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)p);
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, eol));
+        while (mask != 0U)
         {
-            break;
+            char* q = p + __builtin_ctz(mask);
+            if (terminate)
+                *q = '\0';
+            if (plib_flr_index_push(idx, q + 1) == NULL)
+                return NULL;
+            mask &= mask - 1U;
         }
     }
 
-    return flr;
+    return plib_flr_index_range_sse2(idx, p, end, terminate);
 }
+#endif /* PLIB_FLR_HAS_X86_SIMD */
 
-PBLIB_FLR_DEF plib_flr_t*
-plib_flr_init(const char* file_path)
+static plib_flr_index_t*
+plib_flr_index_range(plib_flr_index_t* idx, char* begin, char* end,
+                     int terminate)
 {
-    if (file_path == NULL)
-        return NULL;
+#if PLIB_FLR_HAS_X86_SIMD
+    if (__builtin_cpu_supports("avx2"))
+        return plib_flr_index_range_avx2(idx, begin, end, terminate);
+    return plib_flr_index_range_sse2(idx, begin, end, terminate);
+#else
+    return plib_flr_index_range_scalar(idx, begin, end, terminate);
+#endif
+}
 
-    FILE* fp = fopen(file_path, "r");
-    if (!fp)
+static plib_flr_t*
+plib_flr_detect_lines(plib_flr_t* flr)
+{
+    assert(flr != NULL);
+    assert(flr->file_buffer != NULL);
+    assert(flr->file_size > 0U);
+
+    char* end = flr->file_buffer + flr->file_size;
+    plib_flr_index_t idx = {0};
+
+    /* lazy: lines in front of next are delivered and terminated already */
+    char* next = flr->file_buffer;
+    if (flr->lazy)
+        next = (flr->lazy_next != NULL) ? flr->lazy_next : end;
+    char eol = flr->mapped ? '\n' : '\0';
+
+    /* single pass: first line, then one line per EOL */
+    if (plib_flr_index_push(&idx, flr->file_buffer) == NULL)
     {
-        perror("Could not open file");
+        free(idx.lines);
+        return NULL;
+    }
+    for (char* p = flr->file_buffer; (p = memchr(p, eol, (size_t)(next - p))) != NULL; )
+    {
+        if (plib_flr_index_push(&idx, ++p) == NULL)
+        {
+            free(idx.lines);
+            return NULL;
+        }
+    }
+    if (plib_flr_index_range(&idx, next, end, !flr->mapped) == NULL)
+    {
+        free(idx.lines);
         return NULL;
     }
 
-    plib_flr_t* flr = malloc(sizeof(plib_flr_t));
-    if (flr == NULL)
+    /* EOL at end of file does not start another line */
+    if (idx.lines[idx.num_lines - 1U] == end)
+        idx.num_lines--;
+
+    char** lines = realloc(idx.lines, idx.num_lines * sizeof(char*));
+    flr->lines = (lines != NULL) ? lines : idx.lines;
+    flr->num_lines = idx.num_lines;
+    flr->lazy = 0;
+
+    return flr;
+}
+
+static char*
+plib_flr_lazy_next(plib_flr_t* flr, size_t* length)
+{
+    assert(flr != NULL);
+    assert(flr->lazy);
+
+    char* line = flr->lazy_next;
+    char* end = flr->file_buffer + flr->file_size;
+    if ((line == NULL) || (line == end)) /* EOL at end of file starts no line */
         return NULL;
 
-    flr->fp = fp;
-    if (plib_flr_determine_file_size(flr) == NULL)
+    char* eol = memchr(line, '\n', (size_t)(end - line));
+    if (eol != NULL)
     {
-        perror("Could not determine file size");
-        fclose(flr->fp);
-        free(flr);
-        return NULL;
+        if (!flr->mapped)
+            *eol = '\0';
+        *length = (size_t)(eol - line);
+        flr->lazy_next = eol + 1;
+    }
+    else
+    {
+        *length = (size_t)(end - line);
+        flr->lazy_next = NULL;
     }
 
-    if (plib_flr_read_file(flr) == NULL)
+    return line;
+}
+
+static size_t
+plib_flr_lazy_count(const plib_flr_t* flr)
+{
+    assert(flr != NULL);
+    assert(flr->lazy);
+
+    size_t n = flr->current_line;
+    char* p = flr->lazy_next;
+    char* end = flr->file_buffer + flr->file_size;
+    if ((p == NULL) || (p == end))
+        return n;
+
+    n++;
+    while ((p = memchr(p, '\n', (size_t)(end - p))) != NULL)
+        if (++p < end)
+            n++;
+
+    return n;
+}
+
+#ifdef PLIB_FLR_HAS_THREADS
+typedef struct
+{
+    plib_flr_index_t idx;
+    char* begin;
+    char* end;
+    int terminate;
+    int failed;
+} plib_flr_worker_t;
+
+static void*
+plib_flr_index_worker(void* arg)
+{
+    plib_flr_worker_t* w = arg;
+
+    w->failed = (plib_flr_index_range(&w->idx, w->begin, w->end, w->terminate) == NULL);
+
+    return NULL;
+}
+
+static plib_flr_t*
+plib_flr_detect_lines_parallel(plib_flr_t* flr)
+{
+    assert(flr != NULL);
+    assert(flr->file_buffer != NULL);
+    assert(flr->file_size > 0U);
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t num_threads = flr->file_size / PLIB_FLR_MIN_RANGE;
+    if ((cpus > 0) && (num_threads > (size_t)cpus))
+        num_threads = (size_t)cpus;
+    if (num_threads > PLIB_FLR_MAX_THREADS)
+        num_threads = PLIB_FLR_MAX_THREADS;
+    if (num_threads < 2U)
+        return plib_flr_detect_lines(flr);
+
+    /* each EOL belongs to exactly one range, so ranges need no alignment */
+    plib_flr_worker_t workers[PLIB_FLR_MAX_THREADS] = {0};
+    pthread_t threads[PLIB_FLR_MAX_THREADS];
+    size_t range = flr->file_size / num_threads;
+    for (size_t t = 0U; t < num_threads; t++)
     {
-        perror("Could not read file to buffer");
-        fclose(flr->fp);
-        free(flr);
-        return NULL;
+        workers[t].begin = flr->file_buffer + t * range;
+        workers[t].end = (t == num_threads - 1U) ? flr->file_buffer + flr->file_size
+                                                 : workers[t].begin + range;
+        workers[t].terminate = !flr->mapped;
     }
 
-    fclose(flr->fp);
+    size_t started = 1U;
+    for (; started < num_threads; started++)
+        if (pthread_create(&threads[started], NULL, plib_flr_index_worker, &workers[started]) != 0)
+            break;
+    for (size_t t = started; t < num_threads; t++) /* could not start, do it here */
+        plib_flr_index_worker(&workers[t]);
+    plib_flr_index_worker(&workers[0]);
+    for (size_t t = 1U; t < started; t++)
+        pthread_join(threads[t], NULL);
 
-    if (plib_flr_detect_lines(flr) == NULL)
+    /* stitch: first line, then the lines of all ranges in order */
+    size_t num_lines = 1U;
+    int failed = 0;
+    for (size_t t = 0U; t < num_threads; t++)
     {
-        perror("Could not parse lines");
-        free(flr->file_buffer);
-        free(flr);
-        return NULL;
+        num_lines += workers[t].idx.num_lines;
+        failed |= workers[t].failed;
     }
-    flr->current_line = 0U;
+
+    char** lines = failed ? NULL : malloc(num_lines * sizeof(char*));
+    if (lines != NULL)
+    {
+        lines[0] = flr->file_buffer;
+        size_t n = 1U;
+        for (size_t t = 0U; t < num_threads; t++)
+        {
+            if (workers[t].idx.num_lines > 0U)
+                memcpy(&lines[n], workers[t].idx.lines, workers[t].idx.num_lines * sizeof(char*));
+            n += workers[t].idx.num_lines;
+        }
+    }
+    for (size_t t = 0U; t < num_threads; t++)
+        free(workers[t].idx.lines);
+    if (lines == NULL)
+        return NULL;
+
+    /* EOL at end of file does not start another line */
+    if (lines[num_lines - 1U] == flr->file_buffer + flr->file_size)
+        num_lines--;
+
+    flr->lines = lines;
+    flr->num_lines = num_lines;
 
     return flr;
 }
+#endif /* PLIB_FLR_HAS_THREADS */
 
-PBLIB_FLR_DEF size_t
-plib_flr_num_lines(plib_flr_t* flr)
+static char*
+plib_flr_line_begin(const plib_flr_t* flr, size_t n)
+{
+    assert(flr != NULL);
+    assert(n < flr->num_lines);
+
+    return (flr->offsets != NULL) ? flr->file_buffer + flr->offsets[n]
+                                  : flr->lines[n];
+}
+
+static size_t
+plib_flr_line_length(const plib_flr_t* flr, size_t n)
 {
-    return (flr != NULL) ? flr->num_lines : 0U;
+    assert(flr != NULL);
+    assert(n < flr->num_lines);
+
+    const char* begin = plib_flr_line_begin(flr, n);
+    if (n + 1U < flr->num_lines)
+        return (size_t)(plib_flr_line_begin(flr, n + 1U) - begin) - 1U;
+
+    /* last line, end-of-line is optional (and possibly replaced) */
+    const char* end = flr->file_buffer + flr->file_size;
+    if ((end > begin) && ((end[-1] == '\n') || (end[-1] == '\0')))
+        end--;
+
+    return (size_t)(end - begin);
 }
 
-PBLIB_FLR_DEF const char*
-plib_flr_get_next_line(plib_flr_t* flr, size_t* line)
+/* Get null-terminated line, lines of a sidecar index are terminated late */
+static char*
+plib_flr_terminated_line(plib_flr_t* flr, size_t n)
+{
+    char* begin = plib_flr_line_begin(flr, n);
+
+    if (flr->offsets != NULL)
+        begin[plib_flr_line_length(flr, n)] = '\0';
+
+    return begin;
+}
+
+#ifdef PLIB_FLR_HAS_MMAP
+static char*
+plib_flr_sidecar_path(const char* file_path, const char* suffix)
 {
-    if ((flr == NULL) || (flr->lines == NULL))
+    size_t n = strlen(file_path);
+    char* path = malloc(n + strlen(PLIB_FLR_SIDECAR_SUFFIX) + strlen(suffix) + 1U);
+    if (path == NULL)
         return NULL;
-    if (flr->current_line >= flr->num_lines)
+
+    memcpy(path, file_path, n);
+    strcpy(path + n, PLIB_FLR_SIDECAR_SUFFIX);
+    strcat(path, suffix);
+
+    return path;
+}
+
+static plib_flr_sidecar_t*
+plib_flr_sidecar_key(plib_flr_t* flr, plib_flr_sidecar_t* key)
+{
+    assert(flr != NULL);
+    assert(flr->fp != NULL);
+
+    struct stat st;
+    if (fstat(fileno(flr->fp), &st) != 0)
         return NULL;
 
-    if (line != NULL)
-        *line = flr->current_line + 1U;
+    key->magic = PLIB_FLR_SIDECAR_MAGIC;
+    key->file_size = (uint64_t)flr->file_size;
+    key->mtime_sec = (int64_t)st.st_mtime;
+#ifdef __linux__
+    key->mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+#else
+    key->mtime_nsec = 0;
+#endif
+    key->num_lines = 0U;
 
-    return flr->lines[flr->current_line++];
+    return key;
 }
 
-PBLIB_FLR_DEF const char*
-plib_flr_get_line(plib_flr_t* flr, size_t n)
+static plib_flr_t*
+plib_flr_sidecar_load(plib_flr_t* flr, const char* file_path,
+                      const plib_flr_sidecar_t* key)
 {
-    if ((flr == NULL) || (n > (flr->num_lines - 1U)))
+    char* path = plib_flr_sidecar_path(file_path, "");
+    if (path == NULL)
         return NULL;
 
-    flr->current_line = n - 1U;
+    int fd = open(path, O_RDONLY);
+    free(path);
+    if (fd < 0)
+        return NULL;
 
-    return flr->lines[flr->current_line++];
+    struct stat st;
+    void* p = MAP_FAILED;
+    if ((fstat(fd, &st) == 0) && ((size_t)st.st_size > sizeof(plib_flr_sidecar_t)))
+        p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        return NULL;
+
+    const plib_flr_sidecar_t* h = p;
+    const uint64_t* offsets = (const uint64_t*)(h + 1);
+    int ok =    (h->magic == key->magic)
+             && (h->file_size == key->file_size)
+             && (h->file_size == flr->file_size)
+             && (h->mtime_sec == key->mtime_sec)
+             && (h->mtime_nsec == key->mtime_nsec)
+             && (h->num_lines > 0U)
+             && (h->num_lines <= (SIZE_MAX - sizeof(*h)) / sizeof(uint64_t))
+             && ((size_t)st.st_size == sizeof(*h) + (size_t)h->num_lines * sizeof(uint64_t))
+             && (offsets[0] == 0U);
+
+    /* lines must follow each other within the file, each after an end-of-line */
+    for (size_t i = 1U; ok && (i < (size_t)h->num_lines); i++)
+    {
+        ok =    (offsets[i - 1U] < offsets[i])
+             && (offsets[i] < h->file_size)
+             && (flr->file_buffer[offsets[i] - 1U] == '\n');
+    }
+
+    if (!ok)
+    {
+        munmap(p, (size_t)st.st_size);
+        return NULL;
+    }
+
+    flr->sidecar = p;
+    flr->sidecar_size = (size_t)st.st_size;
+    flr->offsets = offsets;
+    flr->num_lines = (size_t)h->num_lines;
+
+    return flr;
 }
 
-PBLIB_FLR_DEF void
-plib_flr_reset(plib_flr_t* flr)
+static plib_flr_t*
+plib_flr_sidecar_store(plib_flr_t* flr, const char* file_path,
+                       const plib_flr_sidecar_t* key)
 {
-    if (flr == NULL)
-        return;
+    assert(flr->lines != NULL);
 
-    flr->current_line = 0U;
+    char* path = plib_flr_sidecar_path(file_path, "");
+    char* tmp_path = plib_flr_sidecar_path(file_path, ".tmp");
+    FILE* fp = (tmp_path != NULL) ? fopen(tmp_path, "wb") : NULL;
+    if ((path == NULL) || (fp == NULL))
+    {
+        free(path);
+        free(tmp_path);
+        return NULL;
+    }
+
+    plib_flr_sidecar_t h = *key;
+    h.num_lines = flr->num_lines;
+    int ok = (fwrite(&h, sizeof(h), 1, fp) == 1);
+
+    uint64_t buffer[1024];
+    for (size_t i = 0U; ok && (i < flr->num_lines); i += 1024U)
+    {
+        size_t n = (flr->num_lines - i < 1024U) ? flr->num_lines - i : 1024U;
+        for (size_t j = 0U; j < n; j++)
+            buffer[j] = (uint64_t)(flr->lines[i + j] - flr->file_buffer);
+        ok = (fwrite(buffer, sizeof(uint64_t), n, fp) == n);
+    }
+
+    /* replace atomically, a concurrent run never sees a partial index */
+    ok = (fclose(fp) == 0) && ok && (rename(tmp_path, path) == 0);
+    if (!ok)
+        remove(tmp_path);
+    free(path);
+    free(tmp_path);
+
+    return ok ? flr : NULL;
 }
+#endif /* PLIB_FLR_HAS_MMAP */
 
-PBLIB_FLR_DEF void
-plib_flr_free(plib_flr_t* flr)
+#ifdef PLIB_FLR_HAS_THREADS
+typedef struct plib_flr_prefetch
 {
-    if (flr == NULL)
-        return;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int fd;
+    off_t offset;      /* next file offset to read */
+    size_t chunk_size;
+    /* chunks are read to slots[i] + PLIB_FLR_PREFETCH_HEADROOM */
+    char* slots[PLIB_FLR_PREFETCH_SLOTS + 1U];
+    ssize_t sizes[PLIB_FLR_PREFETCH_SLOTS + 1U]; /* 0 at end of file, < 0 on error */
+    int error;         /* errno of a failed read */
+    size_t head;       /* next slot to take */
+    size_t count;      /* filled slots not taken yet */
+    int held;          /* slot before head is the consumer's buffer */
+    char* overflow;    /* line longer than the headroom joined with a chunk */
+    size_t overflow_size;
+    int stop;
+} plib_flr_prefetch_t;
 
-    free(flr->file_buffer);
+static void*
+plib_flr_prefetch_worker(void* arg)
+{
+    plib_flr_prefetch_t* pf = arg;
+    size_t tail = pf->head;
+
+    pthread_mutex_lock(&pf->mutex);
+    for (;;)
+    {
+        while ((pf->count + (size_t)pf->held > PLIB_FLR_PREFETCH_SLOTS) && !pf->stop)
+            pthread_cond_wait(&pf->cond, &pf->mutex);
+        if (pf->stop)
+            break;
+        pthread_mutex_unlock(&pf->mutex);
+
+        /* the slot is not visible to the consumer until count is increased */
+        ssize_t n;
+        do
+            n = pread(pf->fd, pf->slots[tail] + PLIB_FLR_PREFETCH_HEADROOM,
+                      pf->chunk_size, pf->offset);
+        while ((n < 0) && (errno == EINTR));
+
+        pthread_mutex_lock(&pf->mutex);
+        pf->sizes[tail] = n;
+        if (n > 0)
+            pf->offset += n;
+        else if (n < 0)
+            pf->error = errno;
+        tail = (tail + 1U) % (PLIB_FLR_PREFETCH_SLOTS + 1U);
+        pf->count++;
+        pthread_cond_broadcast(&pf->cond);
+        if (n <= 0)
+            break;
+    }
+    pthread_mutex_unlock(&pf->mutex);
+
+    return NULL;
+}
+
+static plib_flr_prefetch_t*
+plib_flr_prefetch_start(plib_flr_prefetch_t* pf)
+{
+    assert(pf != NULL);
+
+    pf->offset = 0;
+    pf->head = 0U;
+    pf->count = 0U;
+    pf->held = 0;
+    pf->error = 0;
+    pf->stop = 0;
+
+    if (pthread_create(&pf->thread, NULL, plib_flr_prefetch_worker, pf) != 0)
+        return NULL;
+
+    return pf;
+}
+
+static void
+plib_flr_prefetch_stop(plib_flr_prefetch_t* pf)
+{
+    assert(pf != NULL);
+
+    pthread_mutex_lock(&pf->mutex);
+    pf->stop = 1;
+    pthread_cond_broadcast(&pf->cond);
+    pthread_mutex_unlock(&pf->mutex);
+    pthread_join(pf->thread, NULL);
+}
+
+static void
+plib_flr_prefetch_free(plib_flr_prefetch_t* pf)
+{
+    if (pf == NULL)
+        return;
+
+    pthread_mutex_destroy(&pf->mutex);
+    pthread_cond_destroy(&pf->cond);
+    for (size_t i = 0U; i < PLIB_FLR_PREFETCH_SLOTS + 1U; i++)
+        free(pf->slots[i]);
+    free(pf->overflow);
+    free(pf);
+}
+
+static plib_flr_prefetch_t*
+plib_flr_prefetch_init(int fd, size_t chunk_size)
+{
+    plib_flr_prefetch_t* pf = calloc(1U, sizeof(plib_flr_prefetch_t));
+    if (pf == NULL)
+        return NULL;
+
+    pthread_mutex_init(&pf->mutex, NULL);
+    pthread_cond_init(&pf->cond, NULL);
+    pf->fd = fd;
+    pf->chunk_size = chunk_size;
+    for (size_t i = 0U; i < PLIB_FLR_PREFETCH_SLOTS + 1U; i++)
+    {
+        if ((pf->slots[i] = malloc(PLIB_FLR_PREFETCH_HEADROOM + chunk_size + 1U)) == NULL)
+        {
+            plib_flr_prefetch_free(pf);
+            return NULL;
+        }
+    }
+
+    if (plib_flr_prefetch_start(pf) == NULL)
+    {
+        plib_flr_prefetch_free(pf);
+        return NULL;
+    }
+
+    return pf;
+}
+
+/*
+ * Continue with the next prefetched chunk, the chunk itself is not copied: the
+ * incomplete line at the end of the current buffer is copied in front of it
+ * (into the headroom). Only if that line is longer than the headroom both are
+ * joined in the overflow buffer. Returns 1, 0 at end of file and -1 on a read
+ * error (errno of the reader) or if out of memory.
+ */
+static int
+plib_flr_prefetch_next(plib_flr_t* flr)
+{
+    plib_flr_prefetch_t* pf = flr->prefetch;
+    assert(pf != NULL);
+
+    pthread_mutex_lock(&pf->mutex);
+    while (pf->count == 0U)
+        pthread_cond_wait(&pf->cond, &pf->mutex);
+    pthread_mutex_unlock(&pf->mutex);
+
+    ssize_t n = pf->sizes[pf->head];
+    if (n < 0)
+    {
+        errno = pf->error;
+        return -1;
+    }
+    if (n == 0)
+        return 0;
+
+    char* chunk = pf->slots[pf->head] + PLIB_FLR_PREFETCH_HEADROOM;
+    size_t rest = flr->fill - flr->pos;
+    char* buffer;
+    if (rest <= PLIB_FLR_PREFETCH_HEADROOM)
+    {
+        buffer = chunk - rest;
+        if (rest > 0U)
+            memcpy(buffer, flr->file_buffer + flr->pos, rest);
+    }
+    else
+    {
+        size_t size = rest + (size_t)n;
+        if (size + 1U > pf->overflow_size)
+        {
+            char* p = realloc(pf->overflow, size + 1U);
+            if (p == NULL)
+                return -1;
+            if (flr->file_buffer == pf->overflow)
+                flr->file_buffer = p;
+            pf->overflow = p;
+            pf->overflow_size = size + 1U;
+        }
+        buffer = pf->overflow;
+        memmove(buffer, flr->file_buffer + flr->pos, rest);
+        memcpy(buffer + rest, chunk, (size_t)n);
+    }
+
+    flr->file_buffer = buffer;
+    flr->fill = rest + (size_t)n;
+    flr->pos = 0U;
+
+    /* previous slot goes back to the reader, the new one is kept unless copied */
+    pthread_mutex_lock(&pf->mutex);
+    pf->head = (pf->head + 1U) % (PLIB_FLR_PREFETCH_SLOTS + 1U);
+    pf->count--;
+    pf->held = (buffer != pf->overflow);
+    pthread_cond_broadcast(&pf->cond);
+    pthread_mutex_unlock(&pf->mutex);
+
+    return 1;
+}
+#endif /* PLIB_FLR_HAS_THREADS */
+
+/*
+ * Keep the incomplete line at the end of the buffer, it straddles the chunk
+ * boundary, and append the next chunk. Returns 1, 0 at end of file and -1 on a
+ * read error or if out of memory.
+ */
+static int
+plib_flr_stream_refill(plib_flr_t* flr)
+{
+#ifdef PLIB_FLR_HAS_THREADS
+    if (flr->prefetch != NULL)
+        return plib_flr_prefetch_next(flr);
+#endif
+
+    size_t rest = flr->fill - flr->pos;
+    memmove(flr->file_buffer, flr->file_buffer + flr->pos, rest);
+    flr->fill = rest;
+    flr->pos = 0U;
+
+    if (flr->fill == flr->capacity) /* line longer than a chunk */
+    {
+        char* p = realloc(flr->file_buffer, flr->capacity * 2U + 1U);
+        if (p == NULL)
+            return -1;
+        flr->file_buffer = p;
+        flr->capacity *= 2U;
+    }
+
+    size_t n = fread(flr->file_buffer + flr->fill, 1, flr->capacity - flr->fill, flr->fp);
+    flr->fill += n;
+    if ((n == 0U) && ferror(flr->fp))
+        return -1;
+
+    return (n > 0U) ? 1 : 0;
+}
+
+static char*
+plib_flr_stream_next(plib_flr_t* flr, size_t* length)
+{
+    assert(flr != NULL);
+    assert(flr->streaming);
+
+    if (flr->file_buffer == NULL) /* no chunk of an empty file or reset failed */
+        return NULL;
+
+    for (;;)
+    {
+        char* line = flr->file_buffer + flr->pos;
+        char* eol = memchr(line, '\n', flr->fill - flr->pos);
+        if (eol != NULL)
+        {
+            *eol = '\0';
+            flr->pos += (size_t)(eol - line) + 1U;
+            *length = (size_t)(eol - line);
+            if (*length > flr->max_length)
+                flr->max_length = *length;
+            return line;
+        }
+
+        if (flr->eof)
+        {
+            if (flr->pos == flr->fill)
+                return NULL;
+            /* last line w/out EOL */
+            flr->file_buffer[flr->fill] = '\0';
+            *length = flr->fill - flr->pos;
+            flr->pos = flr->fill;
+            if (*length > flr->max_length)
+                flr->max_length = *length;
+            return line;
+        }
+
+        int r = plib_flr_stream_refill(flr);
+        if (r < 0)
+        {
+            perror("Could not read file to buffer");
+            return NULL;
+        }
+        if (r == 0)
+            flr->eof = 1;
+    }
+}
+
+#ifdef PLIB_FLR_HAS_FD
+/* Read all of fd, returns 1, 0 if there is no input and -1 on error (errno) */
+static int
+plib_flr_read_fd(plib_flr_t* flr, int fd)
+{
+    assert(flr != NULL);
+
+    size_t capacity = PLIB_FLR_CHUNK_SIZE;
+    size_t fill = 0U;
+    char* buffer = malloc(capacity + 1U);
+    plib_flr_index_t idx = {0};
+    if ((buffer == NULL) || (plib_flr_index_push(&idx, buffer) == NULL))
+        goto error;
+
+    for (;;)
+    {
+        if (fill == capacity)
+        {
+            /* grow geometrically, line beginnings move along */
+            char* p = malloc(capacity * 2U + 1U);
+            if (p == NULL)
+                goto error;
+            memcpy(p, buffer, fill);
+            for (size_t i = 0U; i < idx.num_lines; i++)
+                idx.lines[i] = p + (idx.lines[i] - buffer);
+            free(buffer);
+            buffer = p;
+            capacity *= 2U;
+        }
+
+        ssize_t n = read(fd, buffer + fill, capacity - fill);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            goto error;
+        }
+        if (n == 0)
+            break;
+
+        /* index data as it arrives, while it is still in cache */
+        if (plib_flr_index_range(&idx, buffer + fill, buffer + fill + n, 1) == NULL)
+            goto error;
+        fill += (size_t)n;
+    }
+
+    if (fill == 0U)
+    {
+        free(buffer);
+        free(idx.lines);
+        return 0;
+    }
+
+    buffer[fill] = '\0';
+
+    /* EOL at end of file does not start another line */
+    if (idx.lines[idx.num_lines - 1U] == buffer + fill)
+        idx.num_lines--;
+
+    flr->file_buffer = buffer;
+    flr->file_size = fill;
+    flr->lines = idx.lines;
+    flr->num_lines = idx.num_lines;
+
+    return 1;
+
+error:
+    free(buffer);
+    free(idx.lines);
+    return -1;
+}
+#endif /* PLIB_FLR_HAS_FD */
+
+static void
+plib_flr_release_buffer(plib_flr_t* flr)
+{
+    assert(flr != NULL);
+
+#ifdef PLIB_FLR_HAS_MMAP
+    if (flr->mapped)
+    {
+        munmap(flr->file_buffer, flr->file_size);
+        return;
+    }
+#endif
+    free(flr->file_buffer);
+}
+
+PBLIB_FLR_DEF plib_flr_t*
+plib_flr_init(const char* file_path)
+{
+    return plib_flr_init_ex(file_path, 0U);
+}
+
+PBLIB_FLR_DEF plib_flr_t*
+plib_flr_init_fd(int fd)
+{
+#ifdef PLIB_FLR_HAS_FD
+    if (fd < 0)
+        return NULL;
+
+    plib_flr_t* flr = calloc(1U, sizeof(plib_flr_t));
+    if (flr == NULL)
+        return NULL;
+
+    int r = plib_flr_read_fd(flr, fd);
+    if (r <= 0)
+    {
+        /* errno is not set for empty input */
+        if (r < 0)
+            perror("Could not read file descriptor to buffer");
+        else
+            fprintf(stderr, "Could not read file descriptor to buffer, input empty\n");
+        free(flr);
+        return NULL;
+    }
+
+    return flr;
+#else
+    (void)fd;
+    fprintf(stderr, "File descriptors not supported\n");
+    return NULL;
+#endif
+}
+
+PBLIB_FLR_DEF plib_flr_t*
+plib_flr_init_ex(const char* file_path, unsigned int options)
+{
+    if (file_path == NULL)
+        return NULL;
+
+#ifdef PLIB_FLR_HAS_FD
+    if (strcmp(file_path, "-") == 0)
+        return plib_flr_init_fd(STDIN_FILENO);
+#endif
+
+#ifndef PLIB_FLR_HAS_MMAP
+    if (options & PLIB_FLR_MMAP)
+    {
+        fprintf(stderr, "Memory-mapped files not supported\n");
+        return NULL;
+    }
+#endif
+
+    FILE* fp = fopen(file_path, "r");
+    if (!fp)
+    {
+        perror("Could not open file");
+        return NULL;
+    }
+
+    plib_flr_t* flr = malloc(sizeof(plib_flr_t));
+    if (flr == NULL)
+        return NULL;
+
+    flr->fp = fp;
+    flr->file_buffer = NULL;
+    flr->lines = NULL;
+    flr->max_length = 0U;
+    flr->max_length_known = 0;
+    flr->mapped = 0;
+    flr->streaming = 0;
+    flr->lazy = 0;
+    flr->lazy_next = NULL;
+    flr->offsets = NULL;
+    flr->sidecar = NULL;
+    flr->sidecar_size = 0U;
+    if (plib_flr_determine_file_size(flr) == NULL)
+    {
+#ifdef PLIB_FLR_HAS_FD
+        if ((errno == ESPIPE) && !(options & PLIB_FLR_MMAP)) /* e.g. a pipe */
+        {
+            free(flr);
+            flr = plib_flr_init_fd(fileno(fp));
+            fclose(fp);
+            return flr;
+        }
+#endif
+        perror("Could not determine file size");
+        fclose(flr->fp);
+        free(flr);
+        return NULL;
+    }
+
+    if (flr->file_size == 0U) /* errno is not set */
+    {
+        fprintf(stderr, "Could not read file to buffer, file empty\n");
+        fclose(flr->fp);
+        free(flr);
+        return NULL;
+    }
+
+#ifdef PLIB_FLR_HAS_MMAP
+    if (options & PLIB_FLR_MMAP)
+    {
+        if (plib_flr_map_file(flr, options) == NULL)
+        {
+            perror("Could not map file");
+            fclose(flr->fp);
+            free(flr);
+            return NULL;
+        }
+    }
+    else
+#endif
+    if (plib_flr_read_file(flr) == NULL)
+    {
+        perror("Could not read file to buffer");
+        fclose(flr->fp);
+        free(flr);
+        return NULL;
+    }
+
+#ifdef PLIB_FLR_HAS_MMAP
+    plib_flr_sidecar_t key;
+    int sidecar = (options & PLIB_FLR_SIDECAR) && (plib_flr_sidecar_key(flr, &key) != NULL);
+#endif
+
+    fclose(flr->fp);
+    flr->current_line = 0U;
+
+#ifdef PLIB_FLR_HAS_MMAP
+    if (sidecar)
+    {
+        if (plib_flr_sidecar_load(flr, file_path, &key) != NULL)
+            return flr;
+        options &= ~PLIB_FLR_LAZY; /* index is needed for the sidecar */
+    }
+#endif
+
+    if (options & PLIB_FLR_LAZY)
+    {
+        flr->num_lines = 0U;
+        flr->lazy = 1;
+        flr->lazy_next = flr->file_buffer;
+        return flr;
+    }
+
+#ifdef PLIB_FLR_HAS_THREADS
+    plib_flr_t* (*detect_lines)(plib_flr_t*) = (options & PLIB_FLR_PARALLEL)
+                                             ? plib_flr_detect_lines_parallel
+                                             : plib_flr_detect_lines;
+#else
+    plib_flr_t* (*detect_lines)(plib_flr_t*) = plib_flr_detect_lines;
+#endif
+    if (detect_lines(flr) == NULL)
+    {
+        perror("Could not parse lines");
+        plib_flr_release_buffer(flr);
+        free(flr);
+        return NULL;
+    }
+
+#ifdef PLIB_FLR_HAS_MMAP
+    if (sidecar && (plib_flr_sidecar_store(flr, file_path, &key) == NULL))
+        perror("Could not store line index");
+#endif
+
+    return flr;
+}
+
+PBLIB_FLR_DEF plib_flr_t*
+plib_flr_init_stream(const char* file_path, size_t chunk_size)
+{
+    return plib_flr_init_stream_ex(file_path, chunk_size, 0U);
+}
+
+PBLIB_FLR_DEF plib_flr_t*
+plib_flr_init_stream_ex(const char* file_path, size_t chunk_size,
+                        unsigned int options)
+{
+    if (file_path == NULL)
+        return NULL;
+
+    FILE* fp = fopen(file_path, "r");
+    if (!fp)
+    {
+        perror("Could not open file");
+        return NULL;
+    }
+
+    plib_flr_t* flr = malloc(sizeof(plib_flr_t));
+    if (flr == NULL)
+    {
+        fclose(fp);
+        return NULL;
+    }
+
+    flr->fp = fp;
+    flr->capacity = (chunk_size > 0U) ? chunk_size : PLIB_FLR_CHUNK_SIZE;
+    flr->file_buffer = NULL;
+    flr->prefetch = NULL;
+#ifdef PLIB_FLR_HAS_THREADS
+    /* prefetched chunks are used in place, there is no buffer of its own */
+    if (   (options & PLIB_FLR_PREFETCH)
+        && ((flr->prefetch = plib_flr_prefetch_init(fileno(fp), flr->capacity)) == NULL))
+    {
+        perror("Could not start prefetching");
+        fclose(flr->fp);
+        free(flr);
+        return NULL;
+    }
+#else
+    (void)options;
+#endif
+    if (   (flr->prefetch == NULL)
+        && ((flr->file_buffer = malloc(flr->capacity + 1U)) == NULL))
+    {
+        perror("Could not allocate chunk buffer");
+        fclose(flr->fp);
+        free(flr);
+        return NULL;
+    }
+
+    flr->fill = 0U;
+    flr->pos = 0U;
+    /* an empty file is a stream w/out lines */
+    int r = plib_flr_stream_refill(flr);
+    if (r < 0)
+    {
+        perror("Could not read file to buffer");
+#ifdef PLIB_FLR_HAS_THREADS
+        if (flr->prefetch != NULL)
+        {
+            plib_flr_prefetch_stop(flr->prefetch);
+            plib_flr_prefetch_free(flr->prefetch);
+        }
+#endif
+        free(flr->file_buffer);
+        fclose(flr->fp);
+        free(flr);
+        return NULL;
+    }
+
+    flr->file_size = 0U;
+    flr->lines = NULL;
+    flr->num_lines = 0U;
+    flr->current_line = 0U;
+    flr->max_length = 0U;
+    flr->max_length_known = 1;
+    flr->mapped = 0;
+    flr->streaming = 1;
+    flr->eof = (r == 0);
+    flr->lazy = 0;
+    flr->lazy_next = NULL;
+    flr->offsets = NULL;
+    flr->sidecar = NULL;
+    flr->sidecar_size = 0U;
+
+    return flr;
+}
+
+PBLIB_FLR_DEF size_t
+plib_flr_num_lines(plib_flr_t* flr)
+{
+    if (flr == NULL)
+        return 0U;
+
+    if (flr->lazy)
+        return plib_flr_lazy_count(flr);
+
+    return flr->streaming ? flr->current_line : flr->num_lines;
+}
+
+PBLIB_FLR_DEF size_t
+plib_flr_max_line_length(plib_flr_t* flr)
+{
+    if ((flr == NULL) || (flr->lazy && (plib_flr_detect_lines(flr) == NULL)))
+        return 0U;
+
+    if (!flr->max_length_known)
+    {
+        for (size_t i = 0U; i < flr->num_lines; i++)
+        {
+            size_t length = plib_flr_line_length(flr, i);
+            if (length > flr->max_length)
+                flr->max_length = length;
+        }
+        flr->max_length_known = 1;
+    }
+
+    return flr->max_length;
+}
+
+PBLIB_FLR_DEF const char*
+plib_flr_get_next_line(plib_flr_t* flr, size_t* line)
+{
+    return plib_flr_get_next_line_ex(flr, line, NULL);
+}
+
+PBLIB_FLR_DEF const char*
+plib_flr_get_next_line_ex(plib_flr_t* flr, size_t* line, size_t* length)
+{
+    if ((flr != NULL) && flr->streaming)
+    {
+        size_t n;
+        char* p = plib_flr_stream_next(flr, &n);
+        if (p == NULL)
+            return NULL;
+        if (line != NULL)
+            *line = flr->current_line + 1U;
+        if (length != NULL)
+            *length = n;
+        flr->current_line++;
+        return p;
+    }
+
+    if ((flr != NULL) && flr->lazy && !flr->mapped)
+    {
+        size_t n;
+        char* p = plib_flr_lazy_next(flr, &n);
+        if (p == NULL)
+            return NULL;
+        if (line != NULL)
+            *line = flr->current_line + 1U;
+        if (length != NULL)
+            *length = n;
+        flr->current_line++;
+        return p;
+    }
+
+    if ((flr == NULL) || ((flr->lines == NULL) && (flr->offsets == NULL)) || flr->mapped)
+        return NULL;
+    if (flr->current_line >= flr->num_lines)
+        return NULL;
+
+    if (line != NULL)
+        *line = flr->current_line + 1U;
+    if (length != NULL)
+        *length = plib_flr_line_length(flr, flr->current_line);
+
+    return plib_flr_terminated_line(flr, flr->current_line++);
+}
+
+PBLIB_FLR_DEF const char*
+plib_flr_get_line(plib_flr_t* flr, size_t n)
+{
+    if ((flr == NULL) || (flr->lazy && (plib_flr_detect_lines(flr) == NULL)))
+        return NULL;
+    if (flr->mapped || flr->streaming || (n > (flr->num_lines - 1U)))
+        return NULL;
+
+    flr->current_line = n - 1U;
+
+    return plib_flr_terminated_line(flr, flr->current_line++);
+}
+
+PBLIB_FLR_DEF plib_flr_view_t*
+plib_flr_get_next_view(plib_flr_t* flr, plib_flr_view_t* view, size_t* line)
+{
+    if ((flr != NULL) && (flr->streaming || flr->lazy) && (view != NULL))
+    {
+        view->data = flr->streaming ? plib_flr_stream_next(flr, &view->length)
+                                    : plib_flr_lazy_next(flr, &view->length);
+        if (view->data == NULL)
+            return NULL;
+        if (line != NULL)
+            *line = flr->current_line + 1U;
+        flr->current_line++;
+        return view;
+    }
+
+    if ((flr == NULL) || ((flr->lines == NULL) && (flr->offsets == NULL)) || (view == NULL))
+        return NULL;
+    if (flr->current_line >= flr->num_lines)
+        return NULL;
+
+    if (line != NULL)
+        *line = flr->current_line + 1U;
+
+    view->data = plib_flr_line_begin(flr, flr->current_line);
+    view->length = plib_flr_line_length(flr, flr->current_line);
+    flr->current_line++;
+
+    return view;
+}
+
+PBLIB_FLR_DEF plib_flr_view_t*
+plib_flr_get_view(plib_flr_t* flr, size_t n, plib_flr_view_t* view)
+{
+    if ((flr == NULL) || (flr->lazy && (plib_flr_detect_lines(flr) == NULL)))
+        return NULL;
+    if (flr->streaming || (n == 0U) || (n > flr->num_lines))
+        return NULL;
+
+    flr->current_line = n - 1U;
+
+    return plib_flr_get_next_view(flr, view, NULL);
+}
+
+PBLIB_FLR_DEF plib_flr_view_t*
+plib_flr_get_lines_view(plib_flr_t* flr, size_t first, size_t num_lines,
+                        plib_flr_view_t* view)
+{
+    if (   (flr == NULL) || (view == NULL)
+        || (flr->lazy && (plib_flr_detect_lines(flr) == NULL)))
+        return NULL;
+    if (   flr->streaming || (first == 0U) || (num_lines == 0U)
+        || (first > flr->num_lines) || (num_lines > flr->num_lines - first + 1U))
+        return NULL;
+
+    /* lines are contiguous in the buffer */
+    size_t last = first + num_lines - 2U;
+    const char* begin = plib_flr_line_begin(flr, first - 1U);
+    view->data = begin;
+    view->length = (size_t)(plib_flr_line_begin(flr, last) - begin)
+                 + plib_flr_line_length(flr, last);
+
+    return view;
+}
+
+PBLIB_FLR_DEF int
+plib_flr_is_mapped(const plib_flr_t* flr)
+{
+    return (flr != NULL) && flr->mapped;
+}
+
+PBLIB_FLR_DEF void
+plib_flr_reset(plib_flr_t* flr)
+{
+    if (flr == NULL)
+        return;
+
+    if (flr->streaming)
+    {
+#ifdef PLIB_FLR_HAS_THREADS
+        if (flr->prefetch != NULL)
+        {
+            plib_flr_prefetch_stop(flr->prefetch);
+            if (plib_flr_prefetch_start(flr->prefetch) == NULL)
+            {
+                /* the buffer was a slot of the reader, read chunks w/out it */
+                plib_flr_prefetch_free(flr->prefetch);
+                flr->prefetch = NULL;
+                if ((flr->file_buffer = malloc(flr->capacity + 1U)) == NULL)
+                    perror("Could not allocate chunk buffer");
+            }
+        }
+#endif
+        rewind(flr->fp);
+        flr->fill = 0U;
+        flr->pos = 0U;
+        flr->eof = 0;
+    }
+
+    if (flr->lazy && (plib_flr_detect_lines(flr) == NULL))
+    {
+        perror("Could not parse lines");
+        return;
+    }
+
+    flr->current_line = 0U;
+}
+
+PBLIB_FLR_DEF void
+plib_flr_free(plib_flr_t* flr)
+{
+    if (flr == NULL)
+        return;
+
+    if (flr->streaming)
+    {
+#ifdef PLIB_FLR_HAS_THREADS
+        if (flr->prefetch != NULL)
+        {
+            plib_flr_prefetch_stop(flr->prefetch);
+            plib_flr_prefetch_free(flr->prefetch);
+            flr->file_buffer = NULL; /* was a slot of the reader */
+        }
+#endif
+        fclose(flr->fp);
+    }
+#ifdef PLIB_FLR_HAS_MMAP
+    if (flr->sidecar != NULL)
+        munmap(flr->sidecar, flr->sidecar_size);
+#endif
+    plib_flr_release_buffer(flr);
     free(flr->lines);
     free(flr);
     flr = NULL;
 }
+
+static int
+plib_flr_is_digit(char c)
+{
+    return (unsigned char)(c - '0') < 10U;
+}
+
+#if PLIB_FLR_HAS_SWAR
+/* Number of leading digits in 8 characters loaded little endian */
+static unsigned int
+plib_flr_swar_num_digits(uint64_t chunk)
+{
+    uint64_t v = chunk - 0x3030303030303030ULL;
+    uint64_t non_digit = (chunk | v | (chunk + 0x4646464646464646ULL))
+                       & 0x8080808080808080ULL;
+
+    return (non_digit == 0U) ? 8U : (unsigned int)__builtin_ctzll(non_digit) / 8U;
+}
+
+/* Value of the n (1..8) leading digits in 8 characters loaded little endian */
+static uint64_t
+plib_flr_swar_parse(uint64_t chunk, unsigned int n)
+{
+    uint64_t v = (chunk - 0x3030303030303030ULL) << (8U * (8U - n));
+
+    v = (v * 10U) + (v >> 8U);
+    v = (((v & 0x000000FF000000FFULL) * (100U + (1000000ULL << 32U)))
+        + (((v >> 16U) & 0x000000FF000000FFULL) * (1U + (10000ULL << 32U))))
+        >> 32U;
+
+    return v;
+}
+#endif /* PLIB_FLR_HAS_SWAR */
+
+static const char*
+plib_flr_parse_digits(const char* p, const char* end, unsigned long long* value)
+{
+    unsigned long long v = 0U;
+
+#if PLIB_FLR_HAS_SWAR
+    static const unsigned long long powers[] =
+        {1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U};
+
+    while (end - p >= 8)
+    {
+        uint64_t chunk;
+        memcpy(&chunk, p, sizeof(chunk));
+        unsigned int n = plib_flr_swar_num_digits(chunk);
+        if (n == 0U)
+            break;
+        v = v * powers[n] + plib_flr_swar_parse(chunk, n);
+        p += n;
+        if (n < 8U)
+        {
+            *value = v;
+            return p;
+        }
+    }
+#endif
+
+    while ((p < end) && plib_flr_is_digit(*p))
+        v = v * 10U + (unsigned long long)(*p++ - '0');
+
+    *value = v;
+
+    return p;
+}
+
+PBLIB_FLR_DEF plib_flr_cursor_t*
+plib_flr_cursor_init(plib_flr_cursor_t* c, const char* data, size_t length)
+{
+    if ((c == NULL) || (data == NULL))
+        return NULL;
+
+    c->p = data;
+    c->end = data + length;
+
+    return c;
+}
+
+PBLIB_FLR_DEF plib_flr_cursor_t*
+plib_flr_next_int(plib_flr_cursor_t* c, long long* value)
+{
+    if ((c == NULL) || (value == NULL))
+        return NULL;
+
+    const char* p = c->p;
+    while ((p < c->end) && !plib_flr_is_digit(*p))
+    {
+        if ((*p == '-') && (p + 1 < c->end) && plib_flr_is_digit(p[1]))
+            break;
+        p++;
+    }
+    if (p == c->end)
+    {
+        c->p = p;
+        return NULL;
+    }
+
+    int negative = (*p == '-');
+    if (negative)
+        p++;
+
+    unsigned long long v;
+    c->p = plib_flr_parse_digits(p, c->end, &v);
+    *value = negative ? -(long long)v : (long long)v;
+
+    return c;
+}
+
+PBLIB_FLR_DEF plib_flr_cursor_t*
+plib_flr_next_uint(plib_flr_cursor_t* c, unsigned long long* value)
+{
+    if ((c == NULL) || (value == NULL))
+        return NULL;
+
+    const char* p = c->p;
+    while ((p < c->end) && !plib_flr_is_digit(*p))
+        p++;
+    if (p == c->end)
+    {
+        c->p = p;
+        return NULL;
+    }
+
+    c->p = plib_flr_parse_digits(p, c->end, value);
+
+    return c;
+}
+
+PBLIB_FLR_DEF size_t
+plib_flr_parse_ints(const char* data, size_t length, long long* values,
+                    size_t max_values)
+{
+    plib_flr_cursor_t c;
+    if ((values == NULL) || (plib_flr_cursor_init(&c, data, length) == NULL))
+        return 0U;
+
+    size_t n = 0U;
+    while ((n < max_values) && (plib_flr_next_int(&c, &values[n]) != NULL))
+        n++;
+
+    return n;
+}
 #endif /* PLIB_FLR_IMPLEMENTATION */
 
 #ifndef PLIB_FLR_NO_NAMESPACE_GUARD_
 #define PLIB_FLR_NO_NAMESPACE_GUARD_
 #ifdef PLIB_FLR_NO_NAMESPACE
     #define flr_t plib_flr_t
+    #define flr_view_t plib_flr_view_t
     #define flr_init plib_flr_init
+    #define flr_init_ex plib_flr_init_ex
+    #define flr_init_fd plib_flr_init_fd
+    #define flr_init_stream plib_flr_init_stream
+    #define flr_init_stream_ex plib_flr_init_stream_ex
     #define flr_num_lines plib_flr_num_lines
+    #define flr_max_line_length plib_flr_max_line_length
     #define flr_get_next_line plib_flr_get_next_line
+    #define flr_get_next_line_ex plib_flr_get_next_line_ex
     #define flr_get_line plib_flr_get_line
+    #define flr_get_next_view plib_flr_get_next_view
+    #define flr_get_view plib_flr_get_view
+    #define flr_get_lines_view plib_flr_get_lines_view
+    #define flr_is_mapped plib_flr_is_mapped
     #define flr_reset plib_flr_reset
     #define flr_free plib_flr_free
+    #define flr_cursor_t plib_flr_cursor_t
+    #define flr_cursor_init plib_flr_cursor_init
+    #define flr_next_int plib_flr_next_int
+    #define flr_next_uint plib_flr_next_uint
+    #define flr_parse_ints plib_flr_parse_ints
 #endif /* PLIB_FLR_NO_NAMESPACE */
 #endif /* PLIB_FLR_NO_NAMESPACE_GUARD_ */
 
@@ -1,5 +1,5 @@
 /*
- * PLIB_GRID2D - v0.1.0 - File Line Reader.
+ * PLIB_GRID2D - v0.14.0 - File Line Reader.
  *
  * The GRID2D read contents from a file into memory and allows access to
  * null-terminated lines.
@@ -13,41 +13,589 @@
  *
  * Only UNIX end-of-line (line-feed) supported!
  *
+ * Cells and flags are stored contiguously, row-major: cell (y, x) is at index
+ * PLIB_GRID2D_INDEX(g, y, x) of cells and flag_cells, neighbors are at +/- 1
+ * and +/- stride. The row pointers grid and flags point into the same memory.
+ *
+ * With a border (plib_grid2d_config_t.border) the grid is surrounded by that
+ * many rows and columns of the sentinel character, so neighbor steps need no
+ * bounds checks. Coordinates stay the same, the border is at x, y = -1 etc.
+ * Rows are not null-terminated then.
+ *
+ * Epoch-stamped flags (plib_grid2d_epoch_t) count as set only if their stamp
+ * equals the current epoch, so plib_grid2d_epoch_next clears all of them in
+ * O(1). The cells set in the current epoch are listed in touched.
+ *
+ * A snapshot (plib_grid2d_snapshot_t) is a copy-on-write view of a grid for
+ * what-if trials: changed cells are kept in an epoch-stamped overlay, the grid
+ * itself is not modified. plib_grid2d_snapshot_reset discards all changes in
+ * O(1), so a trial costs only the cells it changes. Snapshots of the same grid
+ * can be used by different threads as long as the grid is not changed.
+ *
+ * plib_grid2d_find_all scans for a character (SSE2 on x86-64). With option
+ * PLIB_GRID2D_CHAR_INDEX the cell indices of all characters are sorted by
+ * character once at initialization, plib_grid2d_positions looks them up. The
+ * index reflects the cells at initialization, later changes are not tracked.
+ *
+ * plib_grid2d_bitplane returns a row-major bit matrix of the cells equal to a
+ * character: bit x % 64 of word y * bitplane_words + x / 64. Planes of all
+ * characters are built at once (option PLIB_GRID2D_BITPLANES or on first use)
+ * and, like the character index, are not updated on changes of the cells.
+ *
+ * plib_grid2d_path_t finds shortest paths from one or more sources: breadth-
+ * first search for unit costs, Dijkstra with a cost callback and A* with an
+ * additional heuristic. A state is a cell or, with headings, a cell and the
+ * direction of the last step. Memory is reused by subsequent runs. The grid
+ * must have a border which is not passable. Dijkstra and A* take states from a
+ * plib_pq queue, a d-ary heap by default. For small integer costs the bucket
+ * queue (max_step: largest cost of a step plus the increase of the heuristic)
+ * or the radix heap are faster; both need a consistent heuristic, so that
+ * distance + heuristic never decreases along a path.
+ *
+ * plib_grid2d_components_init labels 4-connected regions of equal characters
+ * and determines their area and perimeter. Row bands are processed in
+ * parallel (union-find), then joined at the band edges.
+ *
+ * plib_grid2d_for_each and plib_grid2d_reduce call a function for bands of
+ * rows in parallel. A band may read halo rows above and below it, bands are at
+ * least halo rows high. Only the rows of its own band may be written, stencils
+ * that read neighbors write to another layer or grid. Each band reduces into
+ * its own result (separate cache lines), the results are combined in band
+ * order afterwards, so there is no synchronization on the hot path.
+ *
+ * Grids can be created without copying from a buffer (plib_grid2d_init_buffer),
+ * a private file mapping (plib_grid2d_init_mmap) or a range of lines of a
+ * plib_flr buffer (plib_grid2d_init_flr, define PLIB_GRID2D_FLR to include
+ * plib_flr.h). This is zero-copy only w/out border and tiles: the cells stay
+ * in the buffer and end-of-line characters are replaced by terminators (the
+ * last row is terminated only if followed by an end-of-line). Otherwise the
+ * cells are copied and the buffer is only read, the file is mapped read-only.
+ *
+ * With option PLIB_GRID2D_TILED the cells (incl. border) and flags are stored
+ * in tiles of 8 x 8 cells, one cache line of cells, so vertical and diagonal
+ * neighbors are mostly close. There are no row pointers grid and flags then and
+ * neighbors are not at fixed offsets, cells are accessed by plib_grid2d_at or
+ * PLIB_GRID2D_INDEX. Path search and component labeling need row-major cells.
+ * The index computation costs more than it saves unless the grid is much
+ * larger than the caches and mostly walked along columns (bench/grid2d_layout).
+ *
+ * Instead of (or in addition to) the size_t flags, compact flag layers of type
+ * bit, uint8_t, uint16_t or uint32_t can be requested by name at
+ * initialization (plib_grid2d_init_ex). They share the stride of the cells.
+ *
  *
  * Version History
  *
  * 0.1.0 (2024-11-11) First public release
+ * 0.2.0 (2026-10-17) Contiguous cell and flag storage with stride
+ * 0.3.0 (2026-10-17) Typed flag layers
+ * 0.4.0 (2026-10-17) Sentinel border
+ * 0.5.0 (2026-10-17) Epoch-stamped flags
+ * 0.6.0 (2026-10-17) Vectorized find and character index
+ * 0.7.0 (2026-10-17) Per-character bitplanes
+ * 0.8.0 (2026-10-17) Shortest path engine, empty grids
+ * 0.9.0 (2026-10-17) Parallel connected-component labeling
+ * 0.10.0 (2026-10-17) Zero-copy grids of buffers, mappings and plib_flr lines
+ * 0.11.0 (2026-10-17) Tiled storage layout
+ * 0.12.0 (2026-10-17) Copy-on-write snapshots
+ * 0.13.0 (2026-10-17) Parallel for-each and reduce over row bands
+ * 0.14.0 (2026-10-17) Path search on plib_pq queues, cost per heading
  *
  */
 
 #ifndef PLIB_GRID2D_H
 #define PLIB_GRID2D_H
 
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE /* sysconf */
+#endif
+
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef PLIB_GRID2D_FLR
+#include "plib_flr.h"
+#endif
+
+#include "plib_pq.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PLIB_GRID2D_HAS_MMAP
+#define PLIB_GRID2D_HAS_THREADS
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define PLIB_GRID2D_HAS_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define PLIB_GRID2D_HAS_X86_SIMD 0
+#endif
+
 #ifdef PBLIB_GRID2D_STATIC
 #define PBLIB_GRID2D_DEF static
 #else
 #define PBLIB_GRID2D_DEF extern
 #endif
 
+#ifndef PLIB_GRID2D_MAX_LAYERS
+#define PLIB_GRID2D_MAX_LAYERS (8U)
+#endif
+
+#ifndef PLIB_GRID2D_MAX_THREADS
+#define PLIB_GRID2D_MAX_THREADS (64U)
+#endif
+
+/* minimum number of cells per thread */
+#ifndef PLIB_GRID2D_MIN_BAND
+#define PLIB_GRID2D_MIN_BAND (1U << 16U)
+#endif
+
+/* results of bands are aligned to this, power of 2 */
+#ifndef PLIB_GRID2D_CACHE_LINE
+#define PLIB_GRID2D_CACHE_LINE (64U)
+#endif
+
+/* Options for plib_grid2d_init_ex */
+#define PLIB_GRID2D_NO_FLAGS   (1U << 0U) /* do not allocate size_t flags */
+#define PLIB_GRID2D_CHAR_INDEX (1U << 1U) /* build index of cells per character */
+#define PLIB_GRID2D_BITPLANES  (1U << 2U) /* build bitplanes per character */
+#define PLIB_GRID2D_TILED      (1U << 3U) /* store cells in tiles, no row pointers */
+
+/* edge length of tiles is 1 << PLIB_GRID2D_TILE_SHIFT */
+#define PLIB_GRID2D_TILE_SHIFT 3U
+
+typedef enum
+{
+    PLIB_GRID2D_BIT,
+    PLIB_GRID2D_U8,
+    PLIB_GRID2D_U16,
+    PLIB_GRID2D_U32
+} plib_grid2d_type_t;
+
+typedef struct
+{
+    const char* name; /* not copied, must outlive the grid */
+    plib_grid2d_type_t type;
+} plib_grid2d_layer_def_t;
+
+typedef struct
+{
+    unsigned int options;
+    const plib_grid2d_layer_def_t* layers;
+    size_t num_layers;
+    size_t border;     /* width of sentinel border */
+    char sentinel;     /* character of border cells */
+} plib_grid2d_config_t;
+
+typedef struct
+{
+    const char* name;
+    plib_grid2d_type_t type;
+    size_t size; /* in bytes */
+    union
+    {
+        void* data;
+        uint64_t* bits;
+        uint8_t* u8;
+        uint16_t* u16;
+        uint32_t* u32;
+    };
+} plib_grid2d_layer_t;
+
 typedef struct
 {
     FILE* fp;
     size_t file_size;  /* w/out null terminator */
-    char* file_buffer; /* complete file content null terminated */
+    char* file_buffer; /* grid content, NULL w/ border */
     char** grid;
     size_t** flags;
     size_t max_x;
     size_t max_y;
+    char* cells;       /* first cell (of border), row-major */
+    size_t* flag_cells;
+    size_t stride;     /* distance between two rows in cells and flag_cells, 0 if tiled */
+    size_t tiles_x;    /* tiles per row of tiles if tiled, else 0 */
+    size_t border;
+    size_t num_cells;  /* incl. border */
+    char* storage;     /* cells allocated separately from file_buffer */
+    size_t* positions; /* cell indices sorted by character */
+    size_t* char_offsets; /* per character: first entry in positions, 257 */
+    uint64_t** bitplanes; /* per character, absent characters share zero plane */
+    uint64_t* bitplane_storage;
+    size_t bitplane_words; /* words per row of a bitplane */
+    char sentinel;
+    plib_grid2d_layer_t layers[PLIB_GRID2D_MAX_LAYERS];
+    size_t num_layers;
+    int borrowed;      /* file_buffer belongs to caller */
+    void* mapping;     /* file_buffer is a private mapping */
+    size_t mapping_size;
 } plib_grid2d_t;
 
+#define PLIB_GRID2D_INDEX(g, y, x) plib_grid2d_index((g), (y), (x))
+
+/* Index of cell (y, x) in cells and flag_cells */
+static inline size_t
+plib_grid2d_index(const plib_grid2d_t* g, size_t y, size_t x)
+{
+    y += g->border;
+    x += g->border;
+    if (g->tiles_x == 0U)
+        return y * g->stride + x;
+
+    const size_t mask = ((size_t)1U << PLIB_GRID2D_TILE_SHIFT) - 1U;
+    size_t tile = (y >> PLIB_GRID2D_TILE_SHIFT) * g->tiles_x + (x >> PLIB_GRID2D_TILE_SHIFT);
+    return (((tile << PLIB_GRID2D_TILE_SHIFT) + (y & mask)) << PLIB_GRID2D_TILE_SHIFT) + (x & mask);
+}
+
+/* Cell (y, x) in any layout */
+static inline char*
+plib_grid2d_at(const plib_grid2d_t* g, size_t y, size_t x)
+{
+    return g->cells + plib_grid2d_index(g, y, x);
+}
+
+/* Bits of western neighbors (x - 1) aligned to word w of a bitplane row */
+static inline uint64_t
+plib_grid2d_bits_west(const uint64_t* row, size_t w)
+{
+    return (row[w] << 1U) | ((w > 0U) ? (row[w - 1U] >> 63U) : 0U);
+}
+
+/* Bits of eastern neighbors (x + 1) aligned to word w of a bitplane row */
+static inline uint64_t
+plib_grid2d_bits_east(const uint64_t* row, size_t w, size_t words)
+{
+    return (row[w] >> 1U) | ((w + 1U < words) ? (row[w + 1U] << 63U) : 0U);
+}
+
+static inline void
+plib_grid2d_coords(const plib_grid2d_t* g, size_t i, size_t* y, size_t* x)
+{
+    if (g->tiles_x == 0U)
+    {
+        *y = i / g->stride - g->border;
+        *x = i % g->stride - g->border;
+        return;
+    }
+
+    const size_t mask = ((size_t)1U << PLIB_GRID2D_TILE_SHIFT) - 1U;
+    size_t tile = i >> (2U * PLIB_GRID2D_TILE_SHIFT);
+    *y = (((tile / g->tiles_x) << PLIB_GRID2D_TILE_SHIFT) | ((i >> PLIB_GRID2D_TILE_SHIFT) & mask)) - g->border;
+    *x = (((tile % g->tiles_x) << PLIB_GRID2D_TILE_SHIFT) | (i & mask)) - g->border;
+}
+
+static inline size_t
+plib_grid2d_layer_get(const plib_grid2d_layer_t* l, size_t i)
+{
+    switch (l->type)
+    {
+        case PLIB_GRID2D_BIT:
+            return (size_t)((l->bits[i / 64U] >> (i % 64U)) & 1U);
+        case PLIB_GRID2D_U8:
+            return l->u8[i];
+        case PLIB_GRID2D_U16:
+            return l->u16[i];
+        case PLIB_GRID2D_U32:
+            return l->u32[i];
+    }
+    return 0U;
+}
+
+static inline void
+plib_grid2d_layer_set(plib_grid2d_layer_t* l, size_t i, size_t value)
+{
+    switch (l->type)
+    {
+        case PLIB_GRID2D_BIT:
+            if (value)
+                l->bits[i / 64U] |= (uint64_t)1U << (i % 64U);
+            else
+                l->bits[i / 64U] &= ~((uint64_t)1U << (i % 64U));
+            break;
+        case PLIB_GRID2D_U8:
+            l->u8[i] = (uint8_t)value;
+            break;
+        case PLIB_GRID2D_U16:
+            l->u16[i] = (uint16_t)value;
+            break;
+        case PLIB_GRID2D_U32:
+            l->u32[i] = (uint32_t)value;
+            break;
+    }
+}
+
+typedef struct
+{
+    uint32_t* stamps;
+    uint32_t* values;   /* valid only if stamp equals epoch */
+    uint32_t epoch;
+    size_t* touched;    /* cells set in current epoch */
+    size_t num_touched;
+    size_t num_cells;
+} plib_grid2d_epoch_t;
+
+static inline int
+plib_grid2d_epoch_test(const plib_grid2d_epoch_t* e, size_t i)
+{
+    return (e->stamps[i] == e->epoch);
+}
+
+static inline uint32_t
+plib_grid2d_epoch_get(const plib_grid2d_epoch_t* e, size_t i)
+{
+    return (e->stamps[i] == e->epoch) ? e->values[i] : 0U;
+}
+
+/* Add value to cell, setting it first if not set in current epoch */
+static inline uint32_t
+plib_grid2d_epoch_add(plib_grid2d_epoch_t* e, size_t i, uint32_t value)
+{
+    if (e->stamps[i] != e->epoch)
+    {
+        e->stamps[i] = e->epoch;
+        e->values[i] = 0U;
+        e->touched[e->num_touched++] = i;
+    }
+    return e->values[i] += value;
+}
+
+/* Copy-on-write view of base, changes.values hold the changed cells */
+typedef struct
+{
+    const plib_grid2d_t* base;
+    plib_grid2d_epoch_t changes;
+} plib_grid2d_snapshot_t;
+
+static inline char
+plib_grid2d_snapshot_get(const plib_grid2d_snapshot_t* s, size_t i)
+{
+    return plib_grid2d_epoch_test(&s->changes, i) ? (char)s->changes.values[i]
+                                                  : s->base->cells[i];
+}
+
+static inline void
+plib_grid2d_snapshot_set(plib_grid2d_snapshot_t* s, size_t i, char c)
+{
+    plib_grid2d_epoch_t* e = &s->changes;
+    if (e->stamps[i] != e->epoch)
+    {
+        e->stamps[i] = e->epoch;
+        e->touched[e->num_touched++] = i;
+    }
+    e->values[i] = (uint32_t)c;
+}
+
+/* Directions of steps, in order of PLIB_GRID2D_STEPS */
+enum
+{
+    PLIB_GRID2D_UP,
+    PLIB_GRID2D_DOWN,
+    PLIB_GRID2D_LEFT,
+    PLIB_GRID2D_RIGHT
+};
+
+#define PLIB_GRID2D_STEPS(g) {-(ptrdiff_t)(g)->stride, (ptrdiff_t)(g)->stride, -1, 1}
+
+#define PLIB_GRID2D_NO_TARGET (SIZE_MAX)
+
+typedef struct
+{
+    int headings; /* state includes direction of last step */
+    /* cell can be entered, default: not the sentinel */
+    int (*passable)(const plib_grid2d_t* g, size_t i, void* ctx);
+    /* cost of a step (< 0: not possible), default: 1, breadth-first search */
+    int (*cost)(const plib_grid2d_t* g, size_t from, unsigned int from_dir,
+                size_t to, unsigned int to_dir, void* ctx);
+    /* lower bound of the cost from cell to target (A*), default: 0 */
+    int (*heuristic)(const plib_grid2d_t* g, size_t i, void* ctx);
+    void* ctx;
+    int queue;         /* kind of plib_pq (Dijkstra, A*), default: PLIB_PQ_HEAP */
+    uint64_t max_step; /* PLIB_PQ_BUCKET, largest increase of the queue key */
+} plib_grid2d_path_config_t;
+
+typedef struct
+{
+    int dist;
+    size_t state;
+} plib_grid2d_path_node_t;
+
+typedef struct
+{
+    const plib_grid2d_t* g;
+    plib_grid2d_path_config_t config;
+    size_t num_dirs;   /* states per cell */
+    size_t num_states;
+    int* dist;
+    uint32_t* stamps;  /* dist valid only if stamp equals epoch */
+    uint32_t epoch;
+    size_t* queue;     /* breadth-first search */
+    plib_pq_t pq;      /* Dijkstra, A*, key: distance + heuristic */
+} plib_grid2d_path_t;
+
+#define PLIB_GRID2D_NO_LABEL (UINT32_MAX)
+
+typedef struct
+{
+    uint32_t* labels;  /* per cell index, PLIB_GRID2D_NO_LABEL outside grid */
+    size_t num_components;
+    size_t* area;
+    size_t* perimeter;
+} plib_grid2d_components_t;
+
+/* Band of rows y_begin..y_end-1, may read rows halo_begin..halo_end-1 */
+typedef struct
+{
+    const plib_grid2d_t* g;
+    size_t y_begin;
+    size_t y_end;
+    size_t halo_begin;
+    size_t halo_end;
+    size_t index;      /* band number, 0..num_bands-1 */
+    void* ctx;
+    void* result;      /* of this band (plib_grid2d_reduce), NULL otherwise */
+} plib_grid2d_band_t;
+
+typedef void (*plib_grid2d_band_fn)(plib_grid2d_band_t* band);
+
+/* Combine result of a band into acc */
+typedef void (*plib_grid2d_combine_fn)(void* acc, const void* result, void* ctx);
+
 PBLIB_GRID2D_DEF plib_grid2d_t*
 plib_grid2d_init(char* file_path);
 
+PBLIB_GRID2D_DEF plib_grid2d_t*
+plib_grid2d_init_ex(char* file_path, const plib_grid2d_config_t* config);
+
+/* Create grid with all cells set to fill */
+PBLIB_GRID2D_DEF plib_grid2d_t*
+plib_grid2d_init_empty(size_t max_x, size_t max_y, char fill,
+                       const plib_grid2d_config_t* config);
+
+/* Create grid in buffer (w/out border and tiles modified, must outlive the grid) */
+PBLIB_GRID2D_DEF plib_grid2d_t*
+plib_grid2d_init_buffer(char* buffer, size_t size,
+                        const plib_grid2d_config_t* config);
+
+#ifdef PLIB_GRID2D_HAS_MMAP
+/* Create grid in private mapping of file, changes are not written back */
+PBLIB_GRID2D_DEF plib_grid2d_t*
+plib_grid2d_init_mmap(const char* file_path, const plib_grid2d_config_t* config);
+#endif
+
+#ifdef PLIB_GRID2D_FLR
+/* Create grid of lines first..first+num_lines-1 of flr, flr must outlive it */
+PBLIB_GRID2D_DEF plib_grid2d_t*
+plib_grid2d_init_flr(plib_flr_t* flr, size_t first, size_t num_lines,
+                     const plib_grid2d_config_t* config);
+#endif
+
+PBLIB_GRID2D_DEF plib_grid2d_layer_t*
+plib_grid2d_layer(plib_grid2d_t* g, const char* name);
+
+/* Count cells with value & mask != 0 (mask is ignored for bit layers) */
+PBLIB_GRID2D_DEF size_t
+plib_grid2d_layer_count(const plib_grid2d_layer_t* l, size_t mask);
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_layer_clear(plib_grid2d_layer_t* l);
+
+/* Find cell indices of c, returns number of matches (only max are stored) */
+PBLIB_GRID2D_DEF size_t
+plib_grid2d_find_all(const plib_grid2d_t* g, char c, size_t* indices, size_t max);
+
+/* Get cell indices of c from character index */
+PBLIB_GRID2D_DEF const size_t*
+plib_grid2d_positions(const plib_grid2d_t* g, char c, size_t* count);
+
+/* Get bitplane of c, built on first use */
+PBLIB_GRID2D_DEF const uint64_t*
+plib_grid2d_bitplane(plib_grid2d_t* g, char c);
+
+PBLIB_GRID2D_DEF plib_grid2d_epoch_t*
+plib_grid2d_epoch_init(plib_grid2d_epoch_t* e, const plib_grid2d_t* g);
+
+/* Start new epoch, i.e. clear all cells */
+PBLIB_GRID2D_DEF void
+plib_grid2d_epoch_next(plib_grid2d_epoch_t* e);
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_epoch_free(plib_grid2d_epoch_t* e);
+
+/* Initialize snapshot of g, g must not be changed while it is used */
+PBLIB_GRID2D_DEF plib_grid2d_snapshot_t*
+plib_grid2d_snapshot_init(plib_grid2d_snapshot_t* s, const plib_grid2d_t* g);
+
+/* Discard all changes, i.e. take a new snapshot of the grid */
+PBLIB_GRID2D_DEF void
+plib_grid2d_snapshot_reset(plib_grid2d_snapshot_t* s);
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_snapshot_free(plib_grid2d_snapshot_t* s);
+
+/* Prepare searches on g, config may be NULL, NULL if out of memory or invalid queue */
+PBLIB_GRID2D_DEF plib_grid2d_path_t*
+plib_grid2d_path_init(plib_grid2d_path_t* p, const plib_grid2d_t* g,
+                      const plib_grid2d_path_config_t* config);
+
+/*
+ * Search from sources (with initial headings dirs, may be NULL) until target
+ * is reached, returns its cost or -1 if unreachable. With target
+ * PLIB_GRID2D_NO_TARGET all reachable cells are searched. Returns -2 if out
+ * of memory or a key is out of range of the queue.
+ */
+PBLIB_GRID2D_DEF int
+plib_grid2d_path_run(plib_grid2d_path_t* p, const size_t* sources,
+                     const unsigned int* dirs, size_t num_sources, size_t target);
+
+/* Get cost of cell (minimum of all headings) of last run, -1 if not reached */
+PBLIB_GRID2D_DEF int
+plib_grid2d_path_cost(const plib_grid2d_path_t* p, size_t i);
+
+/* Get cost of cell entered with heading dir of last run, -1 if not reached */
+PBLIB_GRID2D_DEF int
+plib_grid2d_path_cost_heading(const plib_grid2d_path_t* p, size_t i, unsigned int dir);
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_path_free(plib_grid2d_path_t* p);
+
+/* Label connected components, num_threads 0: one per CPU */
+PBLIB_GRID2D_DEF plib_grid2d_components_t*
+plib_grid2d_components_init(plib_grid2d_components_t* c, const plib_grid2d_t* g,
+                            size_t num_threads);
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_components_free(plib_grid2d_components_t* c);
+
+/* Call fn for row bands in parallel, returns number of bands or 0 on error */
+PBLIB_GRID2D_DEF size_t
+plib_grid2d_for_each(const plib_grid2d_t* g, size_t halo, size_t num_threads,
+                     plib_grid2d_band_fn fn, void* ctx);
+
+/*
+ * Like plib_grid2d_for_each, but each band reduces into a copy of result (the
+ * identity), which are combined into result in band order afterwards. Returns
+ * result, NULL on error. num_threads 0: one per CPU.
+ */
+PBLIB_GRID2D_DEF void*
+plib_grid2d_reduce(const plib_grid2d_t* g, size_t halo, size_t num_threads,
+                   plib_grid2d_band_fn fn, void* ctx, void* result,
+                   size_t result_size, plib_grid2d_combine_fn combine);
+
+/* Combine function adding size_t results */
+PBLIB_GRID2D_DEF void
+plib_grid2d_combine_sum(void* acc, const void* result, void* ctx);
+
 PBLIB_GRID2D_DEF void
 plib_grid2d_print(plib_grid2d_t* g);
 
@@ -59,6 +607,12 @@ plib_grid2d_free(plib_grid2d_t* g);
 #define PLIB_GRID2D_IMPLEMENTATION
 #ifdef PLIB_GRID2D_IMPLEMENTATION
 
+/* the path engine needs the queues, compiled once with this implementation */
+#ifndef PLIB_PQ_IMPLEMENTATION
+#define PLIB_PQ_IMPLEMENTATION
+#endif
+#include "plib_pq.h"
+
 static plib_grid2d_t*
 plib_grid2d_determine_file_size(plib_grid2d_t* g)
 {
@@ -104,137 +658,1433 @@ plib_grid2d_read_file_content(plib_grid2d_t* g)
     return g;
 }
 
+static void
+plib_grid2d_release_buffer(plib_grid2d_t* g)
+{
+#ifdef PLIB_GRID2D_HAS_MMAP
+    if (g->mapping != NULL)
+        munmap(g->mapping, g->mapping_size);
+    else
+#endif
+    if (!g->borrowed)
+        free(g->file_buffer);
+
+    g->file_buffer = NULL;
+    g->mapping = NULL;
+}
+
+static plib_grid2d_t*
+plib_grid2d_prepare_tiles(plib_grid2d_t* g, unsigned int options)
+{
+    assert(g != NULL);
+
+    const size_t tile = (size_t)1U << PLIB_GRID2D_TILE_SHIFT;
+    size_t tiles_y = (g->max_y + 2U * g->border + tile - 1U) >> PLIB_GRID2D_TILE_SHIFT;
+    g->tiles_x = (g->max_x + 2U * g->border + tile - 1U) >> PLIB_GRID2D_TILE_SHIFT;
+    g->stride = 0U;
+    g->num_cells = tiles_y * g->tiles_x * tile * tile;
+    g->grid = NULL;
+    g->flags = NULL;
+    g->flag_cells = NULL;
+    g->storage = malloc(g->num_cells);
+    if (!(options & PLIB_GRID2D_NO_FLAGS))
+        g->flag_cells = calloc(g->num_cells, sizeof(size_t));
+    if (   (g->storage == NULL)
+        || (!(options & PLIB_GRID2D_NO_FLAGS) && (g->flag_cells == NULL)))
+    {
+        free(g->storage);
+        free(g->flag_cells);
+        return NULL;
+    }
+
+    g->cells = g->storage;
+    memset(g->cells, g->sentinel, g->num_cells);
+    for (size_t y = 0U; y < g->max_y; y++)
+    {
+        const char* row = g->file_buffer + y * (g->max_x + 1U);
+        for (size_t x = 0U; x < g->max_x; x++)
+            *plib_grid2d_at(g, y, x) = row[x];
+    }
+
+    plib_grid2d_release_buffer(g);
+
+    return g;
+}
+
+/* Row y of the grid, gathered to buffer (max_x cells) if tiled */
+static const char*
+plib_grid2d_row(const plib_grid2d_t* g, size_t y, char* buffer)
+{
+    if (g->tiles_x == 0U)
+        return g->grid[y];
+
+    /* runs of cells up to the next tile */
+    const size_t mask = ((size_t)1U << PLIB_GRID2D_TILE_SHIFT) - 1U;
+    size_t n;
+    for (size_t x = 0U; x < g->max_x; x += n)
+    {
+        n = mask + 1U - ((x + g->border) & mask);
+        if (n > g->max_x - x)
+            n = g->max_x - x;
+        memcpy(buffer + x, plib_grid2d_at(g, y, x), n);
+    }
+
+    return buffer;
+}
+
 static plib_grid2d_t*
-plib_grid2d_prepare_grid(plib_grid2d_t* g)
+plib_grid2d_prepare_grid(plib_grid2d_t* g, const plib_grid2d_config_t* config)
 {
     assert(g != NULL);
 
-    /* determine max y by counting EOL */
+    unsigned int options = (config != NULL) ? config->options : 0U;
+    size_t border = (config != NULL) ? config->border : 0U;
+
+    if (g->file_size == 0U)
+        return NULL;
+
+    /* determine max y by counting EOL (or terminators of plib_flr lines) */
+    const char* end = g->file_buffer + g->file_size;
     g->max_y = 0U;
-    for (size_t i = 0U; i < g->file_size; i++)
-        if (g->file_buffer[i] == '\n')
+    for (const char* c = g->file_buffer; c < end; c++)
+        if ((*c == '\n') || (*c == '\0'))
             g->max_y++;
 
-    if (g->file_buffer[g->file_size - 1] != '\n')
+    if ((end[-1] != '\n') && (end[-1] != '\0'))
         g->max_y++;
 
-    g->grid = malloc(g->max_y * sizeof(char*));
-    if (g->grid == NULL)
-        return NULL;
-
     char* p = g->file_buffer;
     g->max_x = 0U;
-    while (*p != '\0' && *p != '\n')
+    while ((p < end) && (*p != '\0') && (*p != '\n'))
     {
         p++;
         g->max_x++;
     }
 
-    p = g->file_buffer;
-    for (size_t i = 0U; i < g->max_y; i++)
+    /* all rows are checked before the buffer is modified */
+    for (size_t y = 0U; y < g->max_y; y++)
     {
-        g->grid[i] = p;
-        size_t line_length = strcspn(p, "\n");
+        const char* row = g->file_buffer + y * (g->max_x + 1U);
+        size_t line_length = 0U;
+        while (   (row + line_length < end)
+               && (row[line_length] != '\n') && (row[line_length] != '\0'))
+            line_length++;
         if (line_length != g->max_x)
         {
-            free(g->grid);
+            errno = EINVAL; /* rows of different length */
             return NULL;
         }
-        g->grid[i][line_length] = '\0';
-        p += line_length + 1U;
-    }
-
-    g->flags = calloc(g->max_y, sizeof(size_t*));
-    if (g->grid == NULL)
-    {
-        free(g->grid);
-        return NULL;
     }
 
-    for (size_t y = 0; y < g->max_y; y++)
+    /* cells stay in the buffer w/out border, end-of-line becomes terminator */
+    if ((border == 0U) && !(options & PLIB_GRID2D_TILED))
     {
-        g->flags[y] = calloc(g->max_x, sizeof(size_t));
-        if (g->flags[y] == NULL)
+        for (size_t y = 0U; y < g->max_y; y++)
         {
-            free(g->grid);
-            free(g->flags);
-            return NULL;
+            char* eol = g->file_buffer + y * (g->max_x + 1U) + g->max_x;
+            if (eol < end)
+                *eol = '\0';
         }
     }
 
-    return g;
-}
-
-PBLIB_GRID2D_DEF plib_grid2d_t*
-plib_grid2d_init(char* file_path)
-{
-    if (file_path == NULL)
-        return NULL;
-
-    plib_grid2d_t* g = malloc(sizeof(plib_grid2d_t));
-    if (g == NULL)
+    size_t rows = g->max_y + 2U * border;
+    g->border = border;
+    g->storage = NULL;
+    g->positions = NULL;
+    g->char_offsets = NULL;
+    g->bitplanes = NULL;
+    g->bitplane_storage = NULL;
+    g->bitplane_words = 0U;
+    g->sentinel = (border > 0U) ? config->sentinel : '\0';
+    g->tiles_x = 0U;
+    if (options & PLIB_GRID2D_TILED)
+        return plib_grid2d_prepare_tiles(g, options);
+    if (border == 0U)
     {
-        perror("Memory allocation error");
-        return NULL;
+        g->cells = g->file_buffer;
+        g->stride = g->max_x + 1U;
     }
-
-    FILE* fp = fopen(file_path, "r");
-    if (!fp)
+    else
     {
-        perror("Could not open file");
-        free(g);
-        return NULL;
+        g->stride = g->max_x + 2U * border;
+        g->storage = malloc(rows * g->stride);
+        if (g->storage == NULL)
+            return NULL;
+        g->cells = g->storage;
+        memset(g->cells, config->sentinel, rows * g->stride);
+        for (size_t y = 0U; y < g->max_y; y++)
+            memcpy(g->cells + PLIB_GRID2D_INDEX(g, y, 0U),
+                   g->file_buffer + y * (g->max_x + 1U), g->max_x);
     }
+    g->num_cells = rows * g->stride;
 
-    g->fp = fp;
-    if (plib_grid2d_determine_file_size(g) == NULL)
+    /* row pointers cover the border too */
+    g->grid = malloc(rows * sizeof(char*));
+    g->flags = NULL;
+    g->flag_cells = NULL;
+    if (!(options & PLIB_GRID2D_NO_FLAGS))
     {
-        perror("Could not determine file size");
-        fclose(g->fp);
-        free(g);
-        return NULL;
+        g->flags = malloc(rows * sizeof(size_t*));
+        g->flag_cells = calloc(g->num_cells, sizeof(size_t));
     }
-
-    if (plib_grid2d_read_file_content(g) == NULL)
+    if (   (g->grid == NULL)
+        || (!(options & PLIB_GRID2D_NO_FLAGS) && ((g->flags == NULL) || (g->flag_cells == NULL))))
     {
-        perror("Could not read file to buffer");
-        fclose(g->fp);
-        free(g);
+        free(g->grid);
+        free(g->flags);
+        free(g->flag_cells);
+        free(g->storage);
         return NULL;
     }
 
-    if (plib_grid2d_prepare_grid(g) == NULL)
+    for (size_t r = 0U; r < rows; r++)
     {
-        perror("Could not prepare grid");
-        fclose(g->fp);
-        free(g);
-        return NULL;
+        g->grid[r] = g->cells + r * g->stride + border;
+        if (g->flags != NULL)
+            g->flags[r] = g->flag_cells + r * g->stride + border;
     }
+    g->grid += border;
+    if (g->flags != NULL)
+        g->flags += border;
 
-    fclose(g->fp);
+    if (border > 0U)
+        plib_grid2d_release_buffer(g);
 
     return g;
 }
 
-PBLIB_GRID2D_DEF void
-plib_grid2d_print(plib_grid2d_t* g)
+static plib_grid2d_t*
+plib_grid2d_prepare_layers(plib_grid2d_t* g, const plib_grid2d_config_t* config)
 {
-    if ((g == NULL) || (g->grid == NULL))
-        return;
+    assert(g != NULL);
 
-    printf("x=%zu, y=%zu:\n", g->max_x, g->max_y);
-    for (size_t i = 0U; i < g->max_y; i++)
-        printf("%s\n", g->grid[i]);
-}
+    g->num_layers = 0U;
+    if ((config == NULL) || (config->layers == NULL))
+        return g;
+
+    if (config->num_layers > PLIB_GRID2D_MAX_LAYERS)
+        return NULL;
+
+    size_t num_cells = g->num_cells;
+    for (size_t i = 0U; i < config->num_layers; i++)
+    {
+        plib_grid2d_layer_t* l = &g->layers[i];
+        l->name = config->layers[i].name;
+        l->type = config->layers[i].type;
+        switch (l->type)
+        {
+            case PLIB_GRID2D_BIT:
+                l->size = ((num_cells + 63U) / 64U) * sizeof(uint64_t);
+                break;
+            case PLIB_GRID2D_U8:
+                l->size = num_cells * sizeof(uint8_t);
+                break;
+            case PLIB_GRID2D_U16:
+                l->size = num_cells * sizeof(uint16_t);
+                break;
+            case PLIB_GRID2D_U32:
+                l->size = num_cells * sizeof(uint32_t);
+                break;
+            default:
+                return NULL;
+        }
+        l->data = calloc(l->size, 1U);
+        if (l->data == NULL)
+            return NULL;
+        g->num_layers++;
+    }
+
+    return g;
+}
+
+static plib_grid2d_t*
+plib_grid2d_prepare_char_index(plib_grid2d_t* g)
+{
+    assert(g != NULL);
+
+    g->char_offsets = calloc(257U, sizeof(size_t));
+    g->positions = malloc(g->max_y * g->max_x * sizeof(size_t));
+    char* scratch = (g->tiles_x != 0U) ? malloc(g->max_x) : NULL;
+    if (   (g->char_offsets == NULL) || (g->positions == NULL)
+        || ((g->tiles_x != 0U) && (scratch == NULL)))
+    {
+        free(scratch);
+        return NULL;
+    }
+
+    /* counting sort: histogram, prefix sum, scatter */
+    size_t* next = g->char_offsets + 1;
+    for (size_t y = 0U; y < g->max_y; y++)
+    {
+        const unsigned char* row = (const unsigned char*)plib_grid2d_row(g, y, scratch);
+        for (size_t x = 0U; x < g->max_x; x++)
+            next[row[x]]++;
+    }
+    for (size_t c = 1U; c < 257U; c++)
+        g->char_offsets[c] += g->char_offsets[c - 1U];
+
+    size_t fill[256];
+    memcpy(fill, g->char_offsets, sizeof(fill));
+    for (size_t y = 0U; y < g->max_y; y++)
+    {
+        const unsigned char* row = (const unsigned char*)plib_grid2d_row(g, y, scratch);
+        if (g->tiles_x != 0U)
+        {
+            for (size_t x = 0U; x < g->max_x; x++)
+                g->positions[fill[row[x]]++] = PLIB_GRID2D_INDEX(g, y, x);
+            continue;
+        }
+        size_t i = PLIB_GRID2D_INDEX(g, y, 0U);
+        for (size_t x = 0U; x < g->max_x; x++)
+            g->positions[fill[row[x]]++] = i + x;
+    }
+    free(scratch);
+
+    return g;
+}
+
+static plib_grid2d_t*
+plib_grid2d_prepare_bitplanes(plib_grid2d_t* g)
+{
+    assert(g != NULL);
+
+    char* scratch = (g->tiles_x != 0U) ? malloc(g->max_x) : NULL;
+    if ((g->tiles_x != 0U) && (scratch == NULL))
+        return NULL;
+
+    unsigned char present[256] = {0};
+    for (size_t y = 0U; y < g->max_y; y++)
+    {
+        const unsigned char* row = (const unsigned char*)plib_grid2d_row(g, y, scratch);
+        for (size_t x = 0U; x < g->max_x; x++)
+            present[row[x]] = 1U;
+    }
+
+    unsigned char symbols[256];
+    size_t num_symbols = 0U;
+    for (size_t c = 0U; c < 256U; c++)
+        if (present[c])
+            symbols[num_symbols++] = (unsigned char)c;
+
+    size_t words = (g->max_x + 63U) / 64U;
+    size_t plane_size = g->max_y * words;
+    g->bitplanes = malloc(256U * sizeof(uint64_t*));
+    g->bitplane_storage = calloc((num_symbols + 1U) * plane_size, sizeof(uint64_t));
+    if ((g->bitplanes == NULL) || (g->bitplane_storage == NULL))
+    {
+        free(scratch);
+        free(g->bitplanes);
+        free(g->bitplane_storage);
+        g->bitplanes = NULL;
+        g->bitplane_storage = NULL;
+        return NULL;
+    }
+    g->bitplane_words = words;
+
+    uint64_t* zero = g->bitplane_storage + num_symbols * plane_size;
+    for (size_t c = 0U; c < 256U; c++)
+        g->bitplanes[c] = zero;
+    for (size_t k = 0U; k < num_symbols; k++)
+        g->bitplanes[symbols[k]] = g->bitplane_storage + k * plane_size;
+
+    for (size_t y = 0U; y < g->max_y; y++)
+    {
+        const char* row = plib_grid2d_row(g, y, scratch);
+        for (size_t w = 0U; w < words; w++)
+        {
+            const char* p = row + w * 64U;
+            size_t n = (g->max_x - w * 64U < 64U) ? g->max_x - w * 64U : 64U;
+#if PLIB_GRID2D_HAS_X86_SIMD
+            if (n == 64U)
+            {
+                __m128i c0 = _mm_loadu_si128((const __m128i*)p);
+                __m128i c1 = _mm_loadu_si128((const __m128i*)(p + 16));
+                __m128i c2 = _mm_loadu_si128((const __m128i*)(p + 32));
+                __m128i c3 = _mm_loadu_si128((const __m128i*)(p + 48));
+                for (size_t k = 0U; k < num_symbols; k++)
+                {
+                    __m128i s = _mm_set1_epi8((char)symbols[k]);
+                    uint64_t m0 = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c0, s));
+                    uint64_t m1 = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c1, s));
+                    uint64_t m2 = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c2, s));
+                    uint64_t m3 = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c3, s));
+                    g->bitplane_storage[k * plane_size + y * words + w] =
+                        m0 | (m1 << 16U) | (m2 << 32U) | (m3 << 48U);
+                }
+                continue;
+            }
+#endif
+            for (size_t i = 0U; i < n; i++)
+                g->bitplanes[(unsigned char)p[i]][y * words + w] |= (uint64_t)1U << i;
+        }
+    }
+    free(scratch);
+
+    return g;
+}
+
+static size_t
+plib_grid2d_find_row(const char* row, size_t n, char c, size_t base,
+                     size_t* indices, size_t max, size_t count)
+{
+    size_t x = 0U;
+#if PLIB_GRID2D_HAS_X86_SIMD
+    const __m128i needle = _mm_set1_epi8(c);
+    for (; x + 16U <= n; x += 16U)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(row + x));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+        while (mask != 0U)
+        {
+            if (count < max)
+                indices[count] = base + x + (size_t)__builtin_ctz(mask);
+            count++;
+            mask &= mask - 1U;
+        }
+    }
+#endif
+    for (; x < n; x++)
+    {
+        if (row[x] == c)
+        {
+            if (count < max)
+                indices[count] = base + x;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/* Prepare grid of file_buffer, frees everything on failure */
+static plib_grid2d_t*
+plib_grid2d_setup(plib_grid2d_t* g, const plib_grid2d_config_t* config)
+{
+    assert(g != NULL);
+
+    g->num_layers = 0U;
+    if (plib_grid2d_prepare_grid(g, config) == NULL)
+    {
+        perror("Could not prepare grid");
+        plib_grid2d_release_buffer(g);
+        free(g);
+        return NULL;
+    }
+
+    if (plib_grid2d_prepare_layers(g, config) == NULL)
+    {
+        perror("Could not allocate flag layers");
+        plib_grid2d_free(g);
+        return NULL;
+    }
+
+    if (   (config != NULL) && (config->options & PLIB_GRID2D_CHAR_INDEX)
+        && (plib_grid2d_prepare_char_index(g) == NULL))
+    {
+        perror("Could not build character index");
+        plib_grid2d_free(g);
+        return NULL;
+    }
+
+    if (   (config != NULL) && (config->options & PLIB_GRID2D_BITPLANES)
+        && (plib_grid2d_prepare_bitplanes(g) == NULL))
+    {
+        perror("Could not build bitplanes");
+        plib_grid2d_free(g);
+        return NULL;
+    }
+
+    return g;
+}
+
+PBLIB_GRID2D_DEF plib_grid2d_t*
+plib_grid2d_init(char* file_path)
+{
+    return plib_grid2d_init_ex(file_path, NULL);
+}
+
+PBLIB_GRID2D_DEF plib_grid2d_t*
+plib_grid2d_init_ex(char* file_path, const plib_grid2d_config_t* config)
+{
+    if (file_path == NULL)
+        return NULL;
+
+    plib_grid2d_t* g = malloc(sizeof(plib_grid2d_t));
+    if (g == NULL)
+    {
+        perror("Memory allocation error");
+        return NULL;
+    }
+
+    FILE* fp = fopen(file_path, "r");
+    if (!fp)
+    {
+        perror("Could not open file");
+        free(g);
+        return NULL;
+    }
+
+    g->fp = fp;
+    if (plib_grid2d_determine_file_size(g) == NULL)
+    {
+        perror("Could not determine file size");
+        fclose(g->fp);
+        free(g);
+        return NULL;
+    }
+
+    if (plib_grid2d_read_file_content(g) == NULL)
+    {
+        perror("Could not read file to buffer");
+        fclose(g->fp);
+        free(g);
+        return NULL;
+    }
+
+    fclose(g->fp);
+    g->fp = NULL;
+    g->borrowed = 0;
+    g->mapping = NULL;
+
+    return plib_grid2d_setup(g, config);
+}
+
+PBLIB_GRID2D_DEF plib_grid2d_t*
+plib_grid2d_init_empty(size_t max_x, size_t max_y, char fill,
+                       const plib_grid2d_config_t* config)
+{
+    assert((fill != '\n') && (fill != '\0'));
+
+    if ((max_x == 0U) || (max_y == 0U))
+        return NULL;
+
+    plib_grid2d_t* g = malloc(sizeof(plib_grid2d_t));
+    if (g == NULL)
+    {
+        perror("Memory allocation error");
+        return NULL;
+    }
+
+    g->fp = NULL;
+    g->borrowed = 0;
+    g->mapping = NULL;
+    g->file_size = max_y * (max_x + 1U);
+    g->file_buffer = malloc(g->file_size + 1U);
+    if (g->file_buffer == NULL)
+    {
+        perror("Memory allocation error");
+        free(g);
+        return NULL;
+    }
+
+    for (size_t y = 0U; y < max_y; y++)
+    {
+        memset(g->file_buffer + y * (max_x + 1U), fill, max_x);
+        g->file_buffer[y * (max_x + 1U) + max_x] = '\n';
+    }
+    g->file_buffer[g->file_size] = '\0';
+
+    return plib_grid2d_setup(g, config);
+}
+
+static plib_grid2d_t*
+plib_grid2d_wrap_buffer(char* buffer, size_t size, int borrowed,
+                        const plib_grid2d_config_t* config)
+{
+    plib_grid2d_t* g = malloc(sizeof(plib_grid2d_t));
+    if (g == NULL)
+    {
+        perror("Memory allocation error");
+        if (!borrowed)
+            free(buffer);
+        return NULL;
+    }
+
+    g->fp = NULL;
+    g->borrowed = borrowed;
+    g->mapping = NULL;
+    g->file_size = size;
+    g->file_buffer = buffer;
+
+    return plib_grid2d_setup(g, config);
+}
+
+PBLIB_GRID2D_DEF plib_grid2d_t*
+plib_grid2d_init_buffer(char* buffer, size_t size,
+                        const plib_grid2d_config_t* config)
+{
+    if ((buffer == NULL) || (size == 0U))
+        return NULL;
+
+    return plib_grid2d_wrap_buffer(buffer, size, 1, config);
+}
+
+#ifdef PLIB_GRID2D_HAS_MMAP
+PBLIB_GRID2D_DEF plib_grid2d_t*
+plib_grid2d_init_mmap(const char* file_path, const plib_grid2d_config_t* config)
+{
+    if (file_path == NULL)
+        return NULL;
+
+    int fd = open(file_path, O_RDONLY);
+    if (fd < 0)
+    {
+        perror("Could not open file");
+        return NULL;
+    }
+
+    /* cells are copied out of the mapping with border or tiles */
+    int in_place =    (config == NULL)
+                   || ((config->border == 0U) && !(config->options & PLIB_GRID2D_TILED));
+    struct stat st;
+    void* p = MAP_FAILED;
+    if ((fstat(fd, &st) == 0) && (st.st_size > 0))
+        p = mmap(NULL, (size_t)st.st_size, in_place ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                 MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+    {
+        perror("Could not map file");
+        return NULL;
+    }
+
+    plib_grid2d_t* g = malloc(sizeof(plib_grid2d_t));
+    if (g == NULL)
+    {
+        perror("Memory allocation error");
+        munmap(p, (size_t)st.st_size);
+        return NULL;
+    }
+
+    g->fp = NULL;
+    g->borrowed = 0;
+    g->mapping = p;
+    g->mapping_size = (size_t)st.st_size;
+    g->file_size = (size_t)st.st_size;
+    g->file_buffer = p;
+
+    return plib_grid2d_setup(g, config);
+}
+#endif /* PLIB_GRID2D_HAS_MMAP */
+
+#ifdef PLIB_GRID2D_FLR
+PBLIB_GRID2D_DEF plib_grid2d_t*
+plib_grid2d_init_flr(plib_flr_t* flr, size_t first, size_t num_lines,
+                     const plib_grid2d_config_t* config)
+{
+    if ((flr == NULL) || (num_lines == 0U))
+        return NULL;
+
+    plib_flr_view_t lines;
+    if (plib_flr_get_lines_view(flr, first, num_lines, &lines) == NULL)
+        return NULL;
+
+    size_t size = lines.length;
+    if (!plib_flr_is_mapped(flr))
+        return plib_grid2d_init_buffer((char*)lines.data, size, config);
+
+    /* mapping of flr is read-only, work on a copy */
+    char* buffer = malloc(size);
+    if (buffer == NULL)
+    {
+        perror("Memory allocation error");
+        return NULL;
+    }
+    memcpy(buffer, lines.data, size);
+
+    return plib_grid2d_wrap_buffer(buffer, size, 0, config);
+}
+#endif /* PLIB_GRID2D_FLR */
+
+PBLIB_GRID2D_DEF plib_grid2d_layer_t*
+plib_grid2d_layer(plib_grid2d_t* g, const char* name)
+{
+    if ((g == NULL) || (name == NULL))
+        return NULL;
+
+    for (size_t i = 0U; i < g->num_layers; i++)
+        if (strcmp(g->layers[i].name, name) == 0)
+            return &g->layers[i];
+
+    return NULL;
+}
+
+PBLIB_GRID2D_DEF size_t
+plib_grid2d_layer_count(const plib_grid2d_layer_t* l, size_t mask)
+{
+    if (l == NULL)
+        return 0U;
+
+    size_t count = 0U;
+    switch (l->type)
+    {
+        case PLIB_GRID2D_BIT:
+            for (size_t i = 0U; i < l->size / sizeof(uint64_t); i++)
+            {
+#if defined(__GNUC__)
+                count += (size_t)__builtin_popcountll(l->bits[i]);
+#else
+                for (uint64_t w = l->bits[i]; w != 0U; w &= w - 1U)
+                    count++;
+#endif
+            }
+            break;
+        case PLIB_GRID2D_U8:
+            for (size_t i = 0U; i < l->size / sizeof(uint8_t); i++)
+                count += ((l->u8[i] & mask) != 0U);
+            break;
+        case PLIB_GRID2D_U16:
+            for (size_t i = 0U; i < l->size / sizeof(uint16_t); i++)
+                count += ((l->u16[i] & mask) != 0U);
+            break;
+        case PLIB_GRID2D_U32:
+            for (size_t i = 0U; i < l->size / sizeof(uint32_t); i++)
+                count += ((l->u32[i] & mask) != 0U);
+            break;
+    }
+
+    return count;
+}
 
 PBLIB_GRID2D_DEF void
-plib_grid2d_free(plib_grid2d_t* g)
+plib_grid2d_layer_clear(plib_grid2d_layer_t* l)
+{
+    if (l != NULL)
+        memset(l->data, 0, l->size);
+}
+
+PBLIB_GRID2D_DEF size_t
+plib_grid2d_find_all(const plib_grid2d_t* g, char c, size_t* indices, size_t max)
+{
+    if (g == NULL)
+        return 0U;
+
+    size_t count = 0U;
+    if (g->tiles_x == 0U)
+    {
+        for (size_t y = 0U; y < g->max_y; y++)
+            count = plib_grid2d_find_row(g->grid[y], g->max_x, c,
+                                         PLIB_GRID2D_INDEX(g, y, 0U),
+                                         indices, (indices != NULL) ? max : 0U, count);
+        return count;
+    }
+
+    char* scratch = malloc(g->max_x);
+    if (scratch == NULL)
+        return 0U;
+    for (size_t y = 0U; y < g->max_y; y++)
+    {
+        /* found at x of the row, then translated to the tiled index */
+        size_t first = count;
+        count = plib_grid2d_find_row(plib_grid2d_row(g, y, scratch), g->max_x, c, 0U,
+                                     indices, (indices != NULL) ? max : 0U, count);
+        for (size_t k = first; (k < count) && (k < max) && (indices != NULL); k++)
+            indices[k] = PLIB_GRID2D_INDEX(g, y, indices[k]);
+    }
+    free(scratch);
+
+    return count;
+}
+
+PBLIB_GRID2D_DEF const size_t*
+plib_grid2d_positions(const plib_grid2d_t* g, char c, size_t* count)
+{
+    if ((g == NULL) || (g->positions == NULL))
+        return NULL;
+
+    unsigned char u = (unsigned char)c;
+    if (count != NULL)
+        *count = g->char_offsets[u + 1U] - g->char_offsets[u];
+
+    return g->positions + g->char_offsets[u];
+}
+
+PBLIB_GRID2D_DEF const uint64_t*
+plib_grid2d_bitplane(plib_grid2d_t* g, char c)
+{
+    if (g == NULL)
+        return NULL;
+
+    if ((g->bitplanes == NULL) && (plib_grid2d_prepare_bitplanes(g) == NULL))
+        return NULL;
+
+    return g->bitplanes[(unsigned char)c];
+}
+
+PBLIB_GRID2D_DEF plib_grid2d_epoch_t*
+plib_grid2d_epoch_init(plib_grid2d_epoch_t* e, const plib_grid2d_t* g)
+{
+    if ((e == NULL) || (g == NULL))
+        return NULL;
+
+    e->num_cells = g->num_cells;
+    e->stamps = calloc(e->num_cells, sizeof(uint32_t));
+    e->values = malloc(e->num_cells * sizeof(uint32_t));
+    e->touched = malloc(e->num_cells * sizeof(size_t));
+    if ((e->stamps == NULL) || (e->values == NULL) || (e->touched == NULL))
+    {
+        plib_grid2d_epoch_free(e);
+        return NULL;
+    }
+    e->epoch = 1U;
+    e->num_touched = 0U;
+
+    return e;
+}
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_epoch_next(plib_grid2d_epoch_t* e)
+{
+    if (e == NULL)
+        return;
+
+    e->num_touched = 0U;
+    if (++e->epoch == 0U)
+    {
+        /* stamps of an earlier epoch would match again after wrap-around */
+        memset(e->stamps, 0, e->num_cells * sizeof(uint32_t));
+        e->epoch = 1U;
+    }
+}
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_epoch_free(plib_grid2d_epoch_t* e)
+{
+    if (e == NULL)
+        return;
+
+    free(e->stamps);
+    free(e->values);
+    free(e->touched);
+    e->stamps = NULL;
+    e->values = NULL;
+    e->touched = NULL;
+    e->num_touched = 0U;
+}
+
+PBLIB_GRID2D_DEF plib_grid2d_snapshot_t*
+plib_grid2d_snapshot_init(plib_grid2d_snapshot_t* s, const plib_grid2d_t* g)
+{
+    if ((s == NULL) || (g == NULL))
+        return NULL;
+
+    s->base = g;
+    if (plib_grid2d_epoch_init(&s->changes, g) == NULL)
+        return NULL;
+
+    return s;
+}
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_snapshot_reset(plib_grid2d_snapshot_t* s)
+{
+    if (s != NULL)
+        plib_grid2d_epoch_next(&s->changes);
+}
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_snapshot_free(plib_grid2d_snapshot_t* s)
+{
+    if (s != NULL)
+        plib_grid2d_epoch_free(&s->changes);
+}
+
+static int
+plib_grid2d_path_relax(plib_grid2d_path_t* p, size_t state, int dist, size_t cell)
+{
+    if ((p->stamps[state] == p->epoch) && (p->dist[state] <= dist))
+        return 0;
+
+    p->stamps[state] = p->epoch;
+    p->dist[state] = dist;
+
+    if (p->config.cost == NULL)
+        return 1; /* queued by caller */
+
+    int h = (p->config.heuristic != NULL)
+          ? p->config.heuristic(p->g, cell, p->config.ctx) : 0;
+    plib_grid2d_path_node_t node = {dist, state};
+
+    /* fails if out of memory or the key is out of range of a monotone queue */
+    if (plib_pq_push(&p->pq, (uint64_t)(dist + h), &node) == NULL)
+        return -1;
+
+    return 1;
+}
+
+PBLIB_GRID2D_DEF plib_grid2d_path_t*
+plib_grid2d_path_init(plib_grid2d_path_t* p, const plib_grid2d_t* g,
+                      const plib_grid2d_path_config_t* config)
+{
+    if ((p == NULL) || (g == NULL) || (g->border == 0U) || (g->tiles_x != 0U))
+        return NULL;
+
+    p->g = g;
+    if (config != NULL)
+        p->config = *config;
+    else
+        p->config = (plib_grid2d_path_config_t){0};
+    p->num_dirs = p->config.headings ? 4U : 1U;
+    p->num_states = g->num_cells * p->num_dirs;
+    p->epoch = 0U;
+    p->queue = NULL;
+    p->pq = (plib_pq_t){0};
+    p->dist = malloc(p->num_states * sizeof(int));
+    p->stamps = calloc(p->num_states, sizeof(uint32_t));
+    int queued = 1;
+    if (p->config.cost == NULL)
+    {
+        p->queue = malloc(p->num_states * sizeof(size_t));
+        queued = (p->queue != NULL);
+    }
+    else
+    {
+        plib_pq_config_t pq_config =
+        {
+            .kind = p->config.queue,
+            .payload_size = sizeof(plib_grid2d_path_node_t),
+            .max_step = p->config.max_step
+        };
+        queued = (plib_pq_init(&p->pq, &pq_config) != NULL);
+    }
+    if ((p->dist == NULL) || (p->stamps == NULL) || !queued)
+    {
+        plib_grid2d_path_free(p);
+        return NULL;
+    }
+
+    return p;
+}
+
+PBLIB_GRID2D_DEF int
+plib_grid2d_path_run(plib_grid2d_path_t* p, const size_t* sources,
+                     const unsigned int* dirs, size_t num_sources, size_t target)
+{
+    if ((p == NULL) || (sources == NULL))
+        return -2;
+
+    if (++p->epoch == 0U)
+    {
+        memset(p->stamps, 0, p->num_states * sizeof(uint32_t));
+        p->epoch = 1U;
+    }
+    plib_pq_clear(&p->pq);
+
+    const plib_grid2d_t* g = p->g;
+    const ptrdiff_t steps[] = PLIB_GRID2D_STEPS(g);
+    const size_t nd = p->num_dirs;
+    size_t head = 0U;
+    size_t tail = 0U;
+
+    for (size_t k = 0U; k < num_sources; k++)
+    {
+        size_t dir = ((dirs != NULL) && (nd > 1U)) ? dirs[k] : 0U;
+        size_t state = sources[k] * nd + dir;
+        int r = plib_grid2d_path_relax(p, state, 0, sources[k]);
+        if (r < 0)
+            return -2;
+        if ((r > 0) && (p->config.cost == NULL))
+            p->queue[tail++] = state;
+    }
+
+    for (;;)
+    {
+        size_t state;
+        int dist;
+        if (p->config.cost == NULL)
+        {
+            if (head == tail)
+                break;
+            state = p->queue[head++];
+            dist = p->dist[state];
+        }
+        else
+        {
+            plib_grid2d_path_node_t node;
+            int r = plib_pq_pop(&p->pq, NULL, &node);
+            if (r == 0)
+                break;
+            if (r < 0)
+                return -2;
+            if (node.dist > p->dist[node.state])
+                continue; /* outdated */
+            state = node.state;
+            dist = node.dist;
+        }
+
+        size_t cell = state / nd;
+        unsigned int dir = (unsigned int)(state % nd);
+        if (cell == target)
+            return dist;
+
+        for (unsigned int d = 0U; d < 4U; d++)
+        {
+            size_t next = (size_t)((ptrdiff_t)cell + steps[d]);
+            int passable = (p->config.passable != NULL)
+                         ? p->config.passable(g, next, p->config.ctx)
+                         : (g->cells[next] != g->sentinel);
+            if (!passable)
+                continue;
+
+            int cost = (p->config.cost != NULL)
+                     ? p->config.cost(g, cell, dir, next, d, p->config.ctx) : 1;
+            if (cost < 0)
+                continue;
+
+            size_t next_state = next * nd + ((nd > 1U) ? d : 0U);
+            int r = plib_grid2d_path_relax(p, next_state, dist + cost, next);
+            if (r < 0)
+                return -2;
+            if ((r > 0) && (p->config.cost == NULL))
+                p->queue[tail++] = next_state;
+        }
+    }
+
+    return -1;
+}
+
+PBLIB_GRID2D_DEF int
+plib_grid2d_path_cost(const plib_grid2d_path_t* p, size_t i)
+{
+    if (p == NULL)
+        return -1;
+
+    int cost = INT_MAX;
+    for (size_t d = 0U; d < p->num_dirs; d++)
+    {
+        size_t state = i * p->num_dirs + d;
+        if ((p->stamps[state] == p->epoch) && (p->dist[state] < cost))
+            cost = p->dist[state];
+    }
+
+    return (cost == INT_MAX) ? -1 : cost;
+}
+
+PBLIB_GRID2D_DEF int
+plib_grid2d_path_cost_heading(const plib_grid2d_path_t* p, size_t i, unsigned int dir)
+{
+    if ((p == NULL) || (dir >= p->num_dirs))
+        return -1;
+
+    size_t state = i * p->num_dirs + dir;
+
+    return (p->stamps[state] == p->epoch) ? p->dist[state] : -1;
+}
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_path_free(plib_grid2d_path_t* p)
+{
+    if (p == NULL)
+        return;
+
+    free(p->dist);
+    free(p->stamps);
+    free(p->queue);
+    plib_pq_free(&p->pq);
+    p->dist = NULL;
+    p->stamps = NULL;
+    p->queue = NULL;
+}
+
+/* Number of row bands to process g with, limited by CPUs and band size */
+static size_t
+plib_grid2d_num_bands(const plib_grid2d_t* g, size_t num_threads)
+{
+#ifdef PLIB_GRID2D_HAS_THREADS
+    if (num_threads == 0U)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = (cpus > 0) ? (size_t)cpus : 1U;
+    }
+#else
+    num_threads = 1U;
+#endif
+    size_t max_bands = (g->max_y * g->max_x) / PLIB_GRID2D_MIN_BAND;
+    if (num_threads > max_bands)
+        num_threads = max_bands;
+    if (num_threads > g->max_y)
+        num_threads = g->max_y;
+    if (num_threads > PLIB_GRID2D_MAX_THREADS)
+        num_threads = PLIB_GRID2D_MAX_THREADS;
+
+    return (num_threads > 0U) ? num_threads : 1U;
+}
+
+/* Run fn for all workers, the first one in the calling thread */
+static void
+plib_grid2d_run_workers(void* (*fn)(void*), void* workers, size_t worker_size,
+                        size_t num_workers)
+{
+    char* w = workers;
+#ifdef PLIB_GRID2D_HAS_THREADS
+    pthread_t threads[PLIB_GRID2D_MAX_THREADS];
+    size_t started = 1U;
+    for (; started < num_workers; started++)
+        if (pthread_create(&threads[started], NULL, fn, w + started * worker_size) != 0)
+            break;
+    for (size_t t = started; t < num_workers; t++) /* could not start, do it here */
+        fn(w + t * worker_size);
+    fn(w);
+    for (size_t t = 1U; t < started; t++)
+        pthread_join(threads[t], NULL);
+#else
+    for (size_t t = 0U; t < num_workers; t++)
+        fn(w + t * worker_size);
+#endif
+}
+
+static uint32_t
+plib_grid2d_uf_find(uint32_t* parent, uint32_t i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]]; /* path halving */
+        i = parent[i];
+    }
+    return i;
+}
+
+static void
+plib_grid2d_uf_union(uint32_t* parent, uint32_t a, uint32_t b)
+{
+    a = plib_grid2d_uf_find(parent, a);
+    b = plib_grid2d_uf_find(parent, b);
+    /* root is the first cell in raster order */
+    if (a < b)
+        parent[b] = a;
+    else if (b < a)
+        parent[a] = b;
+}
+
+typedef struct
+{
+    const plib_grid2d_t* g;
+    size_t y_begin;
+    size_t y_end;
+    uint32_t* parent;
+    uint32_t* labels;
+    size_t* area;      /* per thread, NULL if collected by caller */
+    size_t* perimeter;
+    int phase;
+} plib_grid2d_ccl_worker_t;
+
+static void*
+plib_grid2d_ccl_worker(void* arg)
+{
+    plib_grid2d_ccl_worker_t* w = arg;
+    const plib_grid2d_t* g = w->g;
+
+    for (size_t y = w->y_begin; y < w->y_end; y++)
+    {
+        uint32_t i = (uint32_t)PLIB_GRID2D_INDEX(g, y, 0U);
+        for (size_t x = 0U; x < g->max_x; x++, i++)
+        {
+            if (w->phase == 0)
+            {
+                /* local union-find, neighbors above belong to same band */
+                w->parent[i] = i;
+                if ((x > 0U) && (g->cells[i - 1U] == g->cells[i]))
+                    plib_grid2d_uf_union(w->parent, i - 1U, i);
+                if ((y > w->y_begin) && (g->cells[i - g->stride] == g->cells[i]))
+                    plib_grid2d_uf_union(w->parent, (uint32_t)(i - g->stride), i);
+            }
+            else if (w->phase == 1)
+            {
+                /* resolve roots, read-only */
+                uint32_t r = i;
+                while (w->parent[r] != r)
+                    r = w->parent[r];
+                w->labels[i] = r;
+            }
+            else
+            {
+                uint32_t label = w->labels[i];
+                size_t perimeter = 4U;
+                if ((y > 0U) && (g->cells[i - g->stride] == g->cells[i]))
+                    perimeter--;
+                if ((y < g->max_y - 1U) && (g->cells[i + g->stride] == g->cells[i]))
+                    perimeter--;
+                if ((x > 0U) && (g->cells[i - 1U] == g->cells[i]))
+                    perimeter--;
+                if ((x < g->max_x - 1U) && (g->cells[i + 1U] == g->cells[i]))
+                    perimeter--;
+                w->area[label]++;
+                w->perimeter[label] += perimeter;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+PBLIB_GRID2D_DEF plib_grid2d_components_t*
+plib_grid2d_components_init(plib_grid2d_components_t* c, const plib_grid2d_t* g,
+                            size_t num_threads)
+{
+    if (   (c == NULL) || (g == NULL) || (g->tiles_x != 0U)
+        || (g->num_cells >= PLIB_GRID2D_NO_LABEL))
+        return NULL;
+
+    c->num_components = 0U;
+    c->area = NULL;
+    c->perimeter = NULL;
+    c->labels = malloc(g->num_cells * sizeof(uint32_t));
+    uint32_t* parent = malloc(g->num_cells * sizeof(uint32_t));
+    if ((c->labels == NULL) || (parent == NULL))
+    {
+        free(parent);
+        plib_grid2d_components_free(c);
+        return NULL;
+    }
+
+    memset(c->labels, 0xFF, g->num_cells * sizeof(uint32_t)); /* no label */
+
+    size_t num_bands = plib_grid2d_num_bands(g, num_threads);
+    plib_grid2d_ccl_worker_t workers[PLIB_GRID2D_MAX_THREADS];
+    for (size_t t = 0U; t < num_bands; t++)
+    {
+        workers[t] = (plib_grid2d_ccl_worker_t){
+            .g = g,
+            .y_begin = t * g->max_y / num_bands,
+            .y_end = (t + 1U) * g->max_y / num_bands,
+            .parent = parent,
+            .labels = c->labels,
+            .phase = 0
+        };
+    }
+    plib_grid2d_run_workers(plib_grid2d_ccl_worker, workers, sizeof(workers[0]), num_bands);
+
+    /* join bands at their first row */
+    for (size_t t = 1U; t < num_bands; t++)
+    {
+        uint32_t i = (uint32_t)PLIB_GRID2D_INDEX(g, workers[t].y_begin, 0U);
+        for (size_t x = 0U; x < g->max_x; x++, i++)
+            if (g->cells[i - g->stride] == g->cells[i])
+                plib_grid2d_uf_union(parent, (uint32_t)(i - g->stride), i);
+    }
+
+    for (size_t t = 0U; t < num_bands; t++)
+        workers[t].phase = 1;
+    plib_grid2d_run_workers(plib_grid2d_ccl_worker, workers, sizeof(workers[0]), num_bands);
+
+    /* number components in raster order, roots precede their cells */
+    for (size_t y = 0U; y < g->max_y; y++)
+    {
+        size_t i = PLIB_GRID2D_INDEX(g, y, 0U);
+        for (size_t x = 0U; x < g->max_x; x++, i++)
+        {
+            uint32_t root = c->labels[i];
+            if (root == i)
+                parent[i] = (uint32_t)c->num_components++;
+            c->labels[i] = parent[root];
+        }
+    }
+    free(parent);
+
+    /* statistics, per thread if memory allows */
+    size_t counters = c->num_components * 2U;
+    size_t* stats = NULL;
+    if ((num_bands > 1U) && (num_bands * counters <= g->num_cells))
+        stats = calloc(num_bands * counters, sizeof(size_t));
+    if (stats == NULL)
+        num_bands = 1U;
+
+    c->area = calloc(c->num_components, sizeof(size_t));
+    c->perimeter = calloc(c->num_components, sizeof(size_t));
+    if ((c->area == NULL) || (c->perimeter == NULL))
+    {
+        free(stats);
+        plib_grid2d_components_free(c);
+        return NULL;
+    }
+
+    if (num_bands == 1U)
+    {
+        workers[0] = (plib_grid2d_ccl_worker_t){
+            .g = g,
+            .y_begin = 0U,
+            .y_end = g->max_y,
+            .labels = c->labels,
+            .area = c->area,
+            .perimeter = c->perimeter,
+            .phase = 2
+        };
+        plib_grid2d_ccl_worker(&workers[0]);
+        return c;
+    }
+
+    for (size_t t = 0U; t < num_bands; t++)
+    {
+        workers[t].phase = 2;
+        workers[t].area = stats + t * counters;
+        workers[t].perimeter = workers[t].area + c->num_components;
+    }
+    plib_grid2d_run_workers(plib_grid2d_ccl_worker, workers, sizeof(workers[0]), num_bands);
+
+    for (size_t t = 0U; t < num_bands; t++)
+    {
+        for (size_t k = 0U; k < c->num_components; k++)
+        {
+            c->area[k] += workers[t].area[k];
+            c->perimeter[k] += workers[t].perimeter[k];
+        }
+    }
+    free(stats);
+
+    return c;
+}
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_components_free(plib_grid2d_components_t* c)
+{
+    if (c == NULL)
+        return;
+
+    free(c->labels);
+    free(c->area);
+    free(c->perimeter);
+    c->labels = NULL;
+    c->area = NULL;
+    c->perimeter = NULL;
+    c->num_components = 0U;
+}
+
+typedef struct
+{
+    plib_grid2d_band_t band;
+    plib_grid2d_band_fn fn;
+} plib_grid2d_band_worker_t;
+
+static void*
+plib_grid2d_band_worker(void* arg)
+{
+    plib_grid2d_band_worker_t* w = arg;
+    w->fn(&w->band);
+
+    return NULL;
+}
+
+/* Number of bands, each at least halo rows high */
+static size_t
+plib_grid2d_num_halo_bands(const plib_grid2d_t* g, size_t halo, size_t num_threads)
+{
+    size_t num_bands = plib_grid2d_num_bands(g, num_threads);
+    if ((halo > 0U) && (num_bands > g->max_y / halo))
+        num_bands = (g->max_y / halo > 0U) ? g->max_y / halo : 1U;
+
+    return num_bands;
+}
+
+/* Run fn for num_bands bands, results (slot bytes each) may be NULL */
+static void
+plib_grid2d_run_bands(const plib_grid2d_t* g, size_t halo, size_t num_bands,
+                      plib_grid2d_band_fn fn, void* ctx, char* results, size_t slot)
+{
+    plib_grid2d_band_worker_t workers[PLIB_GRID2D_MAX_THREADS];
+    for (size_t t = 0U; t < num_bands; t++)
+    {
+        size_t y_begin = t * g->max_y / num_bands;
+        size_t y_end = (t + 1U) * g->max_y / num_bands;
+        workers[t] = (plib_grid2d_band_worker_t){
+            .band = {
+                .g = g,
+                .y_begin = y_begin,
+                .y_end = y_end,
+                .halo_begin = (y_begin > halo) ? y_begin - halo : 0U,
+                .halo_end = (g->max_y - y_end > halo) ? y_end + halo : g->max_y,
+                .index = t,
+                .ctx = ctx,
+                .result = (results != NULL) ? results + t * slot : NULL
+            },
+            .fn = fn
+        };
+    }
+    plib_grid2d_run_workers(plib_grid2d_band_worker, workers, sizeof(workers[0]), num_bands);
+}
+
+PBLIB_GRID2D_DEF size_t
+plib_grid2d_for_each(const plib_grid2d_t* g, size_t halo, size_t num_threads,
+                     plib_grid2d_band_fn fn, void* ctx)
+{
+    if ((g == NULL) || (fn == NULL))
+        return 0U;
+
+    size_t num_bands = plib_grid2d_num_halo_bands(g, halo, num_threads);
+    plib_grid2d_run_bands(g, halo, num_bands, fn, ctx, NULL, 0U);
+
+    return num_bands;
+}
+
+PBLIB_GRID2D_DEF void*
+plib_grid2d_reduce(const plib_grid2d_t* g, size_t halo, size_t num_threads,
+                   plib_grid2d_band_fn fn, void* ctx, void* result,
+                   size_t result_size, plib_grid2d_combine_fn combine)
+{
+    if (   (g == NULL) || (fn == NULL) || (result == NULL) || (result_size == 0U)
+        || (combine == NULL))
+        return NULL;
+
+    /* results of the bands in separate cache lines, no false sharing */
+    size_t num_bands = plib_grid2d_num_halo_bands(g, halo, num_threads);
+    size_t slot = (result_size + PLIB_GRID2D_CACHE_LINE - 1U) & ~(size_t)(PLIB_GRID2D_CACHE_LINE - 1U);
+    char* results = aligned_alloc(PLIB_GRID2D_CACHE_LINE, num_bands * slot);
+    if (results == NULL)
+        return NULL;
+    for (size_t t = 0U; t < num_bands; t++)
+        memcpy(results + t * slot, result, result_size);
+
+    plib_grid2d_run_bands(g, halo, num_bands, fn, ctx, results, slot);
+
+    for (size_t t = 0U; t < num_bands; t++)
+        combine(result, results + t * slot, ctx);
+    free(results);
+
+    return result;
+}
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_combine_sum(void* acc, const void* result, void* ctx)
 {
-    free(g->file_buffer);
+    (void)ctx;
+    *(size_t*)acc += *(const size_t*)result;
+}
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_print(plib_grid2d_t* g)
+{
+    if ((g == NULL) || (g->cells == NULL))
+        return;
+
+    printf("x=%zu, y=%zu:\n", g->max_x, g->max_y);
     for (size_t y = 0U; y < g->max_y; y++)
-        free(g->flags[y]);
-    free(g->flags);
-    free(g->grid);
+    {
+        if (g->grid != NULL)
+            printf("%.*s\n", (int)g->max_x, g->grid[y]);
+        else
+        {
+            for (size_t x = 0U; x < g->max_x; x++)
+                putchar(*plib_grid2d_at(g, y, x));
+            putchar('\n');
+        }
+    }
+}
+
+PBLIB_GRID2D_DEF void
+plib_grid2d_free(plib_grid2d_t* g)
+{
+    plib_grid2d_release_buffer(g);
+    free(g->storage);
+    free(g->positions);
+    free(g->char_offsets);
+    free(g->bitplanes);
+    free(g->bitplane_storage);
+    free(g->flag_cells);
+    if (g->flags != NULL)
+        free(g->flags - g->border);
+    for (size_t i = 0U; i < g->num_layers; i++)
+        free(g->layers[i].data);
+    if (g->grid != NULL)
+        free(g->grid - g->border);
     free(g);
 
     return;
@@ -246,6 +2096,56 @@ plib_grid2d_free(plib_grid2d_t* g)
 #ifdef PLIB_GRID2D_NO_NAMESPACE
     #define grid2d_t plib_grid2d_t
     #define grid2d_init plib_grid2d_init
+    #define grid2d_init_ex plib_grid2d_init_ex
+    #define grid2d_init_empty plib_grid2d_init_empty
+    #define grid2d_init_buffer plib_grid2d_init_buffer
+    #define grid2d_init_mmap plib_grid2d_init_mmap
+    #define grid2d_init_flr plib_grid2d_init_flr
+    #define grid2d_config_t plib_grid2d_config_t
+    #define grid2d_layer_def_t plib_grid2d_layer_def_t
+    #define grid2d_layer_t plib_grid2d_layer_t
+    #define grid2d_layer plib_grid2d_layer
+    #define grid2d_layer_get plib_grid2d_layer_get
+    #define grid2d_layer_set plib_grid2d_layer_set
+    #define grid2d_layer_count plib_grid2d_layer_count
+    #define grid2d_layer_clear plib_grid2d_layer_clear
+    #define grid2d_coords plib_grid2d_coords
+    #define grid2d_index plib_grid2d_index
+    #define grid2d_at plib_grid2d_at
+    #define grid2d_bitplane plib_grid2d_bitplane
+    #define grid2d_bits_west plib_grid2d_bits_west
+    #define grid2d_bits_east plib_grid2d_bits_east
+    #define grid2d_find_all plib_grid2d_find_all
+    #define grid2d_positions plib_grid2d_positions
+    #define grid2d_epoch_t plib_grid2d_epoch_t
+    #define grid2d_epoch_init plib_grid2d_epoch_init
+    #define grid2d_epoch_next plib_grid2d_epoch_next
+    #define grid2d_epoch_test plib_grid2d_epoch_test
+    #define grid2d_epoch_get plib_grid2d_epoch_get
+    #define grid2d_epoch_add plib_grid2d_epoch_add
+    #define grid2d_epoch_free plib_grid2d_epoch_free
+    #define grid2d_snapshot_t plib_grid2d_snapshot_t
+    #define grid2d_snapshot_init plib_grid2d_snapshot_init
+    #define grid2d_snapshot_get plib_grid2d_snapshot_get
+    #define grid2d_snapshot_set plib_grid2d_snapshot_set
+    #define grid2d_snapshot_reset plib_grid2d_snapshot_reset
+    #define grid2d_snapshot_free plib_grid2d_snapshot_free
+    #define grid2d_path_config_t plib_grid2d_path_config_t
+    #define grid2d_path_t plib_grid2d_path_t
+    #define grid2d_path_init plib_grid2d_path_init
+    #define grid2d_path_run plib_grid2d_path_run
+    #define grid2d_path_cost plib_grid2d_path_cost
+    #define grid2d_path_cost_heading plib_grid2d_path_cost_heading
+    #define grid2d_path_free plib_grid2d_path_free
+    #define grid2d_components_t plib_grid2d_components_t
+    #define grid2d_components_init plib_grid2d_components_init
+    #define grid2d_components_free plib_grid2d_components_free
+    #define grid2d_band_t plib_grid2d_band_t
+    #define grid2d_band_fn plib_grid2d_band_fn
+    #define grid2d_combine_fn plib_grid2d_combine_fn
+    #define grid2d_for_each plib_grid2d_for_each
+    #define grid2d_reduce plib_grid2d_reduce
+    #define grid2d_combine_sum plib_grid2d_combine_sum
     #define grid2d_print plib_grid2d_print
     #define grid2d_free plib_grid2d_free
 #endif /* PLIB_GRID2D_NO_NAMESPACE */
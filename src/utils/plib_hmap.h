@@ -0,0 +1,504 @@
+/*
+ * plib_hmap - v0.1.0 - Integer Hash Map.
+ *
+ * The HMAP maps 64-bit unsigned integer keys to 64-bit unsigned integer values
+ * using open addressing.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2024 "piscilus" Julian Kraemer
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *
+ * Notes
+ *
+ * Slots are organized in groups of PLIB_HMAP_GROUP. Each slot has a control
+ * byte: empty, deleted or 7 bits of the hash of its key. A lookup probes one
+ * group after the other (triangular sequence) and compares all control bytes
+ * of a group at once (SSE2 on x86-64, otherwise bytewise), so keys are only
+ * compared for matching control bytes. A lookup ends at the first group with
+ * an empty slot.
+ *
+ * The map grows (doubles) when more than 7/8 of the slots are used or deleted.
+ * plib_hmap_reserve makes room for a number of keys in advance, so no rehash
+ * happens while they are inserted. Pointers to values are valid until the next
+ * insertion.
+ *
+ * A map pays off for many repeated keys in no particular order, like the
+ * stones of day 11. For data that is sorted anyway a binary search is faster
+ * (bench/hmap).
+ *
+ * Unlike plib_flr and plib_grid2d the implementation is only compiled with
+ * PLIB_HMAP_IMPLEMENTATION defined.
+ *
+ *
+ * Version History
+ *
+ * 0.1.0 (2026-10-17) First release
+ *
+ */
+
+#ifndef PLIB_HMAP_H
+#define PLIB_HMAP_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define PLIB_HMAP_HAS_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define PLIB_HMAP_HAS_X86_SIMD 0
+#endif
+
+#ifdef PBLIB_HMAP_STATIC
+#define PBLIB_HMAP_DEF static
+#else
+#define PBLIB_HMAP_DEF extern
+#endif
+
+/* slots per group, compared at once */
+#define PLIB_HMAP_GROUP (16U)
+
+typedef struct
+{
+    int8_t* ctrl;      /* per slot: empty, deleted or 7 bits of hash */
+    uint64_t* keys;
+    uint64_t* values;
+    size_t capacity;   /* slots, power of 2, multiple of PLIB_HMAP_GROUP */
+    size_t size;       /* keys */
+    size_t deleted;
+} plib_hmap_t;
+
+/* Initialize for at least capacity keys (0: none yet), NULL if out of memory */
+PBLIB_HMAP_DEF plib_hmap_t*
+plib_hmap_init(plib_hmap_t* m, size_t capacity);
+
+/* Make room for n keys in total */
+PBLIB_HMAP_DEF plib_hmap_t*
+plib_hmap_reserve(plib_hmap_t* m, size_t n);
+
+/* Get value of key, NULL if not present */
+PBLIB_HMAP_DEF uint64_t*
+plib_hmap_get(const plib_hmap_t* m, uint64_t key);
+
+/* Get value of key, inserted with value 0 if not present, NULL if out of memory */
+PBLIB_HMAP_DEF uint64_t*
+plib_hmap_insert(plib_hmap_t* m, uint64_t key, int* inserted);
+
+/* Set value of key */
+PBLIB_HMAP_DEF uint64_t*
+plib_hmap_put(plib_hmap_t* m, uint64_t key, uint64_t value);
+
+/* Add delta to value of key (0 if not present) */
+PBLIB_HMAP_DEF uint64_t*
+plib_hmap_add(plib_hmap_t* m, uint64_t key, uint64_t delta);
+
+/*
+ * Insert n keys at once with their values, if values is NULL the value of each
+ * key is incremented instead (histogram). Returns m, NULL if out of memory.
+ */
+PBLIB_HMAP_DEF plib_hmap_t*
+plib_hmap_insert_bulk(plib_hmap_t* m, const uint64_t* keys,
+                      const uint64_t* values, size_t n);
+
+/* Remove key, returns 1 if it was present */
+PBLIB_HMAP_DEF int
+plib_hmap_remove(plib_hmap_t* m, uint64_t key);
+
+/* Iterate, start with *it = 0, returns 0 after the last key */
+PBLIB_HMAP_DEF int
+plib_hmap_next(const plib_hmap_t* m, size_t* it, uint64_t* key, uint64_t* value);
+
+/* Remove all keys, memory is kept */
+PBLIB_HMAP_DEF void
+plib_hmap_clear(plib_hmap_t* m);
+
+PBLIB_HMAP_DEF void
+plib_hmap_free(plib_hmap_t* m);
+
+#endif /* PLIB_HMAP_H */
+
+#if defined(PLIB_HMAP_IMPLEMENTATION) && !defined(PLIB_HMAP_IMPLEMENTATION_DONE_)
+#define PLIB_HMAP_IMPLEMENTATION_DONE_
+
+#define PLIB_HMAP_EMPTY   ((int8_t)-128)
+#define PLIB_HMAP_DELETED ((int8_t)-2)
+
+static inline uint64_t
+plib_hmap_hash(uint64_t key)
+{
+    /* finalizer of MurmurHash3 */
+    key ^= key >> 33U;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33U;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33U;
+
+    return key;
+}
+
+/* Index of the lowest set bit of a non-zero match mask */
+static inline size_t
+plib_hmap_first(unsigned int match)
+{
+    assert(match != 0U);
+#if defined(__GNUC__)
+    return (size_t)__builtin_ctz(match);
+#else
+    size_t i = 0U;
+    while ((match & 1U) == 0U)
+    {
+        match >>= 1U;
+        i++;
+    }
+    return i;
+#endif
+}
+
+/* Bit i set if control byte i of the group equals c */
+static inline unsigned int
+plib_hmap_match(const int8_t* group, int8_t c)
+{
+#if PLIB_HMAP_HAS_X86_SIMD
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(c)));
+#else
+    unsigned int mask = 0U;
+    for (unsigned int i = 0U; i < PLIB_HMAP_GROUP; i++)
+        mask |= (unsigned int)(group[i] == c) << i;
+    return mask;
+#endif
+}
+
+/* Bit i set if slot i of the group is empty or deleted */
+static inline unsigned int
+plib_hmap_match_free(const int8_t* group)
+{
+#if PLIB_HMAP_HAS_X86_SIMD
+    /* only empty and deleted have the sign bit set */
+    return (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    unsigned int mask = 0U;
+    for (unsigned int i = 0U; i < PLIB_HMAP_GROUP; i++)
+        mask |= (unsigned int)(group[i] < 0) << i;
+    return mask;
+#endif
+}
+
+/* Slot of key, capacity if not present */
+static size_t
+plib_hmap_find(const plib_hmap_t* m, uint64_t key, uint64_t hash)
+{
+    if (m->capacity == 0U)
+        return 0U;
+
+    size_t mask = m->capacity / PLIB_HMAP_GROUP - 1U;
+    size_t group = (size_t)(hash >> 7U) & mask;
+    int8_t h2 = (int8_t)(hash & 0x7FU);
+    for (size_t step = 1U; ; step++)
+    {
+        const int8_t* ctrl = m->ctrl + group * PLIB_HMAP_GROUP;
+        unsigned int match = plib_hmap_match(ctrl, h2);
+        while (match != 0U)
+        {
+            size_t slot = group * PLIB_HMAP_GROUP + plib_hmap_first(match);
+            if (m->keys[slot] == key)
+                return slot;
+            match &= match - 1U;
+        }
+        if ((plib_hmap_match(ctrl, PLIB_HMAP_EMPTY) != 0U) || (step > mask))
+            return m->capacity;
+        group = (group + step) & mask;
+    }
+}
+
+/* First empty or deleted slot of the probe sequence of hash */
+static size_t
+plib_hmap_find_free(const plib_hmap_t* m, uint64_t hash)
+{
+    size_t mask = m->capacity / PLIB_HMAP_GROUP - 1U;
+    size_t group = (size_t)(hash >> 7U) & mask;
+    for (size_t step = 1U; ; step++)
+    {
+        unsigned int match = plib_hmap_match_free(m->ctrl + group * PLIB_HMAP_GROUP);
+        if (match != 0U)
+            return group * PLIB_HMAP_GROUP + plib_hmap_first(match);
+        group = (group + step) & mask;
+    }
+}
+
+static plib_hmap_t*
+plib_hmap_rehash(plib_hmap_t* m, size_t capacity)
+{
+    plib_hmap_t n = {0};
+    n.capacity = capacity;
+    n.ctrl = malloc(capacity);
+    n.keys = malloc(capacity * sizeof(uint64_t));
+    n.values = malloc(capacity * sizeof(uint64_t));
+    if ((n.ctrl == NULL) || (n.keys == NULL) || (n.values == NULL))
+    {
+        plib_hmap_free(&n);
+        return NULL;
+    }
+    memset(n.ctrl, PLIB_HMAP_EMPTY, capacity);
+
+    for (size_t i = 0U; i < m->capacity; i++)
+    {
+        if (m->ctrl[i] < 0)
+            continue;
+        uint64_t hash = plib_hmap_hash(m->keys[i]);
+        size_t slot = plib_hmap_find_free(&n, hash);
+        n.ctrl[slot] = (int8_t)(hash & 0x7FU);
+        n.keys[slot] = m->keys[i];
+        n.values[slot] = m->values[i];
+    }
+    n.size = m->size;
+
+    plib_hmap_free(m);
+    *m = n;
+
+    return m;
+}
+
+/* Smallest capacity for n keys */
+static size_t
+plib_hmap_capacity_for(size_t n)
+{
+    size_t capacity = PLIB_HMAP_GROUP;
+    while (capacity - capacity / 8U < n)
+        capacity *= 2U;
+
+    return capacity;
+}
+
+PBLIB_HMAP_DEF plib_hmap_t*
+plib_hmap_init(plib_hmap_t* m, size_t capacity)
+{
+    if (m == NULL)
+        return NULL;
+
+    *m = (plib_hmap_t){0};
+    if (capacity == 0U)
+        return m;
+
+    return plib_hmap_reserve(m, capacity);
+}
+
+PBLIB_HMAP_DEF plib_hmap_t*
+plib_hmap_reserve(plib_hmap_t* m, size_t n)
+{
+    if (m == NULL)
+        return NULL;
+
+    size_t capacity = plib_hmap_capacity_for(n);
+    if (capacity <= m->capacity)
+        return m;
+
+    return plib_hmap_rehash(m, capacity);
+}
+
+PBLIB_HMAP_DEF uint64_t*
+plib_hmap_get(const plib_hmap_t* m, uint64_t key)
+{
+    if (m == NULL)
+        return NULL;
+
+    size_t slot = plib_hmap_find(m, key, plib_hmap_hash(key));
+
+    return (slot < m->capacity) ? &m->values[slot] : NULL;
+}
+
+PBLIB_HMAP_DEF uint64_t*
+plib_hmap_insert(plib_hmap_t* m, uint64_t key, int* inserted)
+{
+    if (m == NULL)
+        return NULL;
+
+    uint64_t hash = plib_hmap_hash(key);
+    size_t slot = plib_hmap_find(m, key, hash);
+    if (inserted != NULL)
+        *inserted = (slot >= m->capacity);
+    if (slot < m->capacity)
+        return &m->values[slot];
+
+    if (m->size + m->deleted + 1U > m->capacity - m->capacity / 8U)
+    {
+        /* grow, or only drop deleted slots if there are many */
+        size_t capacity = plib_hmap_capacity_for(m->size + 1U);
+        if (capacity <= m->capacity)
+            capacity = (m->deleted > m->size) ? m->capacity : m->capacity * 2U;
+        if (plib_hmap_rehash(m, capacity) == NULL)
+            return NULL;
+    }
+
+    slot = plib_hmap_find_free(m, hash);
+    if (m->ctrl[slot] == PLIB_HMAP_DELETED)
+        m->deleted--;
+    m->ctrl[slot] = (int8_t)(hash & 0x7FU);
+    m->keys[slot] = key;
+    m->values[slot] = 0U;
+    m->size++;
+
+    return &m->values[slot];
+}
+
+PBLIB_HMAP_DEF uint64_t*
+plib_hmap_put(plib_hmap_t* m, uint64_t key, uint64_t value)
+{
+    uint64_t* v = plib_hmap_insert(m, key, NULL);
+    if (v != NULL)
+        *v = value;
+
+    return v;
+}
+
+PBLIB_HMAP_DEF uint64_t*
+plib_hmap_add(plib_hmap_t* m, uint64_t key, uint64_t delta)
+{
+    uint64_t* v = plib_hmap_insert(m, key, NULL);
+    if (v != NULL)
+        *v += delta;
+
+    return v;
+}
+
+PBLIB_HMAP_DEF plib_hmap_t*
+plib_hmap_insert_bulk(plib_hmap_t* m, const uint64_t* keys,
+                      const uint64_t* values, size_t n)
+{
+    if ((m == NULL) || ((keys == NULL) && (n > 0U)))
+        return NULL;
+
+    /* at most n new keys, no rehash in between */
+    if (plib_hmap_reserve(m, m->size + n) == NULL)
+        return NULL;
+
+    for (size_t i = 0U; i < n; i++)
+    {
+        uint64_t* v = plib_hmap_insert(m, keys[i], NULL);
+        if (v == NULL)
+            return NULL;
+        if (values != NULL)
+            *v = values[i];
+        else
+            (*v)++;
+    }
+
+    return m;
+}
+
+PBLIB_HMAP_DEF int
+plib_hmap_remove(plib_hmap_t* m, uint64_t key)
+{
+    if (m == NULL)
+        return 0;
+
+    size_t slot = plib_hmap_find(m, key, plib_hmap_hash(key));
+    if (slot >= m->capacity)
+        return 0;
+
+    /* a group with an empty slot ends all lookups, no tombstone needed */
+    const int8_t* group = m->ctrl + slot / PLIB_HMAP_GROUP * PLIB_HMAP_GROUP;
+    if (plib_hmap_match(group, PLIB_HMAP_EMPTY) != 0U)
+        m->ctrl[slot] = PLIB_HMAP_EMPTY;
+    else
+    {
+        m->ctrl[slot] = PLIB_HMAP_DELETED;
+        m->deleted++;
+    }
+    m->size--;
+
+    return 1;
+}
+
+PBLIB_HMAP_DEF int
+plib_hmap_next(const plib_hmap_t* m, size_t* it, uint64_t* key, uint64_t* value)
+{
+    if ((m == NULL) || (it == NULL))
+        return 0;
+
+    for (; *it < m->capacity; (*it)++)
+    {
+        if (m->ctrl[*it] >= 0)
+        {
+            if (key != NULL)
+                *key = m->keys[*it];
+            if (value != NULL)
+                *value = m->values[*it];
+            (*it)++;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+PBLIB_HMAP_DEF void
+plib_hmap_clear(plib_hmap_t* m)
+{
+    if ((m == NULL) || (m->ctrl == NULL))
+        return;
+
+    memset(m->ctrl, PLIB_HMAP_EMPTY, m->capacity);
+    m->size = 0U;
+    m->deleted = 0U;
+}
+
+PBLIB_HMAP_DEF void
+plib_hmap_free(plib_hmap_t* m)
+{
+    if (m == NULL)
+        return;
+
+    free(m->ctrl);
+    free(m->keys);
+    free(m->values);
+    *m = (plib_hmap_t){0};
+}
+#endif /* PLIB_HMAP_IMPLEMENTATION */
+
+#ifndef PLIB_HMAP_NO_NAMESPACE_GUARD_
+#define PLIB_HMAP_NO_NAMESPACE_GUARD_
+#ifdef PLIB_HMAP_NO_NAMESPACE
+    #define hmap_t plib_hmap_t
+    #define hmap_init plib_hmap_init
+    #define hmap_reserve plib_hmap_reserve
+    #define hmap_get plib_hmap_get
+    #define hmap_insert plib_hmap_insert
+    #define hmap_put plib_hmap_put
+    #define hmap_add plib_hmap_add
+    #define hmap_insert_bulk plib_hmap_insert_bulk
+    #define hmap_remove plib_hmap_remove
+    #define hmap_next plib_hmap_next
+    #define hmap_clear plib_hmap_clear
+    #define hmap_free plib_hmap_free
+#endif /* PLIB_HMAP_NO_NAMESPACE */
+#endif /* PLIB_HMAP_NO_NAMESPACE_GUARD_ */
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 "piscilus" Julian Kraemer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
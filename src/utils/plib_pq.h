@@ -0,0 +1,515 @@
+/*
+ * plib_pq - v0.1.0 - Priority Queues.
+ *
+ * The PQ keeps elements of a fixed payload size ordered by 64-bit unsigned
+ * integer keys and pops the one with the smallest key first.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2024 "piscilus" Julian Kraemer
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *
+ * Notes
+ *
+ * The kind of queue is selected at initialization, the interface is the same:
+ *
+ * PLIB_PQ_HEAP is a d-ary heap (plib_pq_config_t.arity, default 4). Keys can be
+ * pushed in any order. A larger arity makes the heap flatter, so pushes (sift
+ * up) get cheaper and pops (sift down) compare more children, which are in the
+ * same cache line.
+ *
+ * PLIB_PQ_RADIX is a radix heap for monotone keys: no key pushed may be smaller
+ * than the last key popped, as with Dijkstra's algorithm and non-negative
+ * costs. Elements are kept in buckets by the highest bit in which their key
+ * differs from the last key popped, a pop redistributes only the first
+ * non-empty bucket. Pushes are O(1), pops amortized O(log of the key range).
+ *
+ * PLIB_PQ_BUCKET is a bucket queue for monotone keys in a window: each key
+ * pushed must be at most plib_pq_config_t.max_step larger than the last key
+ * popped, e.g. the largest cost of a step. There is one bucket per key of the
+ * window (circular), so a push is O(1) and a pop skips the empty buckets up to
+ * the next key. Suited to small sets of costs like 1 and 1000.
+ *
+ * Each element is stored as its key followed by the payload, padded to a
+ * multiple of 8 bytes, and copied in and out. Elements with equal keys are
+ * popped in no particular order. The monotone queues measure from the last key
+ * popped, 0 after initialization and plib_pq_clear.
+ *
+ * Like plib_hmap the implementation is only compiled with
+ * PLIB_PQ_IMPLEMENTATION defined.
+ *
+ *
+ * Version History
+ *
+ * 0.1.0 (2026-10-17) First release
+ *
+ */
+
+#ifndef PLIB_PQ_H
+#define PLIB_PQ_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef PBLIB_PQ_STATIC
+#define PBLIB_PQ_DEF static
+#else
+#define PBLIB_PQ_DEF extern
+#endif
+
+enum
+{
+    PLIB_PQ_HEAP,
+    PLIB_PQ_RADIX,
+    PLIB_PQ_BUCKET
+};
+
+/* buckets of the radix heap: equal to last key, highest differing bit 0..63 */
+#define PLIB_PQ_RADIX_BUCKETS (65U)
+
+typedef struct
+{
+    int kind;
+    size_t payload_size;
+    size_t arity;     /* PLIB_PQ_HEAP, default: 4 */
+    uint64_t max_step; /* PLIB_PQ_BUCKET, largest key above the last popped */
+    size_t capacity;  /* elements to allocate in advance (PLIB_PQ_HEAP) */
+} plib_pq_config_t;
+
+typedef struct
+{
+    unsigned char* data;
+    size_t size;      /* elements */
+    size_t capacity;
+} plib_pq_vec_t;
+
+typedef struct
+{
+    int kind;
+    size_t payload_size;
+    size_t record_size; /* key and payload, multiple of 8 */
+    size_t arity;
+    size_t size;        /* elements in total */
+    plib_pq_vec_t heap;
+    plib_pq_vec_t* buckets;
+    size_t num_buckets;
+    uint64_t last;      /* key of the last pop (monotone queues) */
+    size_t current;     /* bucket of last (PLIB_PQ_BUCKET) */
+    unsigned char* tmp; /* one record */
+} plib_pq_t;
+
+/* Initialize, NULL if out of memory or invalid configuration */
+PBLIB_PQ_DEF plib_pq_t*
+plib_pq_init(plib_pq_t* pq, const plib_pq_config_t* config);
+
+/* Push element, payload may be NULL if payload_size is 0, NULL if out of memory */
+PBLIB_PQ_DEF plib_pq_t*
+plib_pq_push(plib_pq_t* pq, uint64_t key, const void* payload);
+
+/*
+ * Pop element with the smallest key, key and payload may be NULL. Returns 0 if
+ * empty, -1 if out of memory (PLIB_PQ_RADIX).
+ */
+PBLIB_PQ_DEF int
+plib_pq_pop(plib_pq_t* pq, uint64_t* key, void* payload);
+
+/* Remove all elements, memory is kept */
+PBLIB_PQ_DEF void
+plib_pq_clear(plib_pq_t* pq);
+
+PBLIB_PQ_DEF void
+plib_pq_free(plib_pq_t* pq);
+
+#endif /* PLIB_PQ_H */
+
+#if defined(PLIB_PQ_IMPLEMENTATION) && !defined(PLIB_PQ_IMPLEMENTATION_DONE_)
+#define PLIB_PQ_IMPLEMENTATION_DONE_
+
+static inline uint64_t
+plib_pq_key(const unsigned char* record)
+{
+    uint64_t key;
+    memcpy(&key, record, sizeof(key));
+    return key;
+}
+
+static inline unsigned char*
+plib_pq_record(const plib_pq_t* pq, const plib_pq_vec_t* v, size_t i)
+{
+    return v->data + i * pq->record_size;
+}
+
+/* Make room for n more records in v, NULL if out of memory */
+static plib_pq_vec_t*
+plib_pq_vec_reserve(const plib_pq_t* pq, plib_pq_vec_t* v, size_t n)
+{
+    if (v->size + n <= v->capacity)
+        return v;
+
+    size_t capacity = (v->capacity == 0U) ? 16U : 2U * v->capacity;
+    while (capacity < v->size + n)
+        capacity *= 2U;
+    unsigned char* data = realloc(v->data, capacity * pq->record_size);
+    if (data == NULL)
+        return NULL;
+    v->data = data;
+    v->capacity = capacity;
+
+    return v;
+}
+
+/* Append a record to v, returns it, NULL if out of memory */
+static inline unsigned char*
+plib_pq_vec_push(const plib_pq_t* pq, plib_pq_vec_t* v)
+{
+    if (plib_pq_vec_reserve(pq, v, 1U) == NULL)
+        return NULL;
+
+    return plib_pq_record(pq, v, v->size++);
+}
+
+static inline void
+plib_pq_write(const plib_pq_t* pq, unsigned char* record, uint64_t key,
+              const void* payload)
+{
+    memcpy(record, &key, sizeof(key));
+    if (pq->payload_size > 0U)
+        memcpy(record + sizeof(key), payload, pq->payload_size);
+}
+
+static inline void
+plib_pq_read(const plib_pq_t* pq, const unsigned char* record, uint64_t* key,
+             void* payload)
+{
+    if (key != NULL)
+        *key = plib_pq_key(record);
+    if ((payload != NULL) && (pq->payload_size > 0U))
+        memcpy(payload, record + sizeof(uint64_t), pq->payload_size);
+}
+
+/* Radix heap bucket of key: 0 if equal to last, else 1 + highest differing bit */
+static inline size_t
+plib_pq_radix_bucket(const plib_pq_t* pq, uint64_t key)
+{
+    uint64_t diff = key ^ pq->last;
+    if (diff == 0U)
+        return 0U;
+#if defined(__GNUC__)
+    return 64U - (size_t)__builtin_clzll(diff);
+#else
+    size_t bits = 0U;
+    while (diff != 0U)
+    {
+        diff >>= 1U;
+        bits++;
+    }
+    return bits;
+#endif
+}
+
+static plib_pq_t*
+plib_pq_heap_push(plib_pq_t* pq, uint64_t key, const void* payload)
+{
+    if (plib_pq_vec_push(pq, &pq->heap) == NULL)
+        return NULL;
+
+    /* sift up, the new element is written once at its final place */
+    size_t i = pq->heap.size - 1U;
+    while (i > 0U)
+    {
+        size_t parent = (i - 1U) / pq->arity;
+        unsigned char* p = plib_pq_record(pq, &pq->heap, parent);
+        if (plib_pq_key(p) <= key)
+            break;
+        memcpy(plib_pq_record(pq, &pq->heap, i), p, pq->record_size);
+        i = parent;
+    }
+    plib_pq_write(pq, plib_pq_record(pq, &pq->heap, i), key, payload);
+
+    return pq;
+}
+
+static void
+plib_pq_heap_pop(plib_pq_t* pq, uint64_t* key, void* payload)
+{
+    plib_pq_read(pq, plib_pq_record(pq, &pq->heap, 0U), key, payload);
+
+    size_t n = --pq->heap.size;
+    if (n == 0U)
+        return;
+
+    unsigned char* last = pq->tmp;
+    memcpy(last, plib_pq_record(pq, &pq->heap, n), pq->record_size);
+    uint64_t last_key = plib_pq_key(last);
+
+    /* sift down */
+    size_t i = 0U;
+    for (;;)
+    {
+        size_t first = pq->arity * i + 1U;
+        if (first >= n)
+            break;
+        size_t end = (first + pq->arity < n) ? first + pq->arity : n;
+        size_t child = first;
+        uint64_t child_key = plib_pq_key(plib_pq_record(pq, &pq->heap, first));
+        for (size_t c = first + 1U; c < end; c++)
+        {
+            uint64_t k = plib_pq_key(plib_pq_record(pq, &pq->heap, c));
+            if (k < child_key)
+            {
+                child = c;
+                child_key = k;
+            }
+        }
+        if (last_key <= child_key)
+            break;
+        memcpy(plib_pq_record(pq, &pq->heap, i),
+               plib_pq_record(pq, &pq->heap, child), pq->record_size);
+        i = child;
+    }
+    memcpy(plib_pq_record(pq, &pq->heap, i), last, pq->record_size);
+}
+
+static int
+plib_pq_radix_pop(plib_pq_t* pq, uint64_t* key, void* payload)
+{
+    if (pq->buckets[0].size == 0U)
+    {
+        size_t b = 1U;
+        while (pq->buckets[b].size == 0U)
+            b++;
+
+        /* the smallest key of the bucket becomes last, all move to lower buckets */
+        plib_pq_vec_t* v = &pq->buckets[b];
+        uint64_t min = plib_pq_key(plib_pq_record(pq, v, 0U));
+        for (size_t i = 1U; i < v->size; i++)
+        {
+            uint64_t k = plib_pq_key(plib_pq_record(pq, v, i));
+            if (k < min)
+                min = k;
+        }
+
+        /* make room first, so the heap is unchanged if out of memory */
+        uint64_t last = pq->last;
+        pq->last = min;
+        size_t counts[PLIB_PQ_RADIX_BUCKETS] = {0};
+        for (size_t i = 0U; i < v->size; i++)
+            counts[plib_pq_radix_bucket(pq, plib_pq_key(plib_pq_record(pq, v, i)))]++;
+        for (size_t t = 0U; t < b; t++)
+        {
+            if (plib_pq_vec_reserve(pq, &pq->buckets[t], counts[t]) == NULL)
+            {
+                pq->last = last;
+                return -1;
+            }
+        }
+
+        for (size_t i = 0U; i < v->size; i++)
+        {
+            const unsigned char* r = plib_pq_record(pq, v, i);
+            plib_pq_vec_t* to = &pq->buckets[plib_pq_radix_bucket(pq, plib_pq_key(r))];
+            memcpy(plib_pq_record(pq, to, to->size++), r, pq->record_size);
+        }
+        v->size = 0U;
+    }
+
+    plib_pq_vec_t* v = &pq->buckets[0];
+    plib_pq_read(pq, plib_pq_record(pq, v, --v->size), key, payload);
+
+    return 1;
+}
+
+static void
+plib_pq_bucket_pop(plib_pq_t* pq, uint64_t* key, void* payload)
+{
+    while (pq->buckets[pq->current].size == 0U)
+    {
+        pq->current = (pq->current + 1U == pq->num_buckets) ? 0U : pq->current + 1U;
+        pq->last++;
+    }
+
+    plib_pq_vec_t* v = &pq->buckets[pq->current];
+    plib_pq_read(pq, plib_pq_record(pq, v, --v->size), key, payload);
+}
+
+PBLIB_PQ_DEF plib_pq_t*
+plib_pq_init(plib_pq_t* pq, const plib_pq_config_t* config)
+{
+    if ((pq == NULL) || (config == NULL))
+        return NULL;
+
+    *pq = (plib_pq_t){0};
+    pq->kind = config->kind;
+    pq->payload_size = config->payload_size;
+    pq->record_size = sizeof(uint64_t) + ((config->payload_size + 7U) & ~(size_t)7U);
+    pq->arity = (config->arity >= 2U) ? config->arity : 4U;
+
+    switch (config->kind)
+    {
+        case PLIB_PQ_HEAP:
+            if (config->capacity > 0U)
+            {
+                pq->heap.data = malloc(config->capacity * pq->record_size);
+                if (pq->heap.data == NULL)
+                    return NULL;
+                pq->heap.capacity = config->capacity;
+            }
+            break;
+        case PLIB_PQ_RADIX:
+            pq->num_buckets = PLIB_PQ_RADIX_BUCKETS;
+            break;
+        case PLIB_PQ_BUCKET:
+            if ((config->max_step == 0U) || (config->max_step >= SIZE_MAX / sizeof(plib_pq_vec_t)))
+                return NULL;
+            pq->num_buckets = (size_t)config->max_step + 1U;
+            break;
+        default:
+            return NULL;
+    }
+
+    if (pq->num_buckets > 0U)
+        pq->buckets = calloc(pq->num_buckets, sizeof(plib_pq_vec_t));
+    pq->tmp = malloc(pq->record_size);
+    if (((pq->num_buckets > 0U) && (pq->buckets == NULL)) || (pq->tmp == NULL))
+    {
+        plib_pq_free(pq);
+        return NULL;
+    }
+
+    return pq;
+}
+
+PBLIB_PQ_DEF plib_pq_t*
+plib_pq_push(plib_pq_t* pq, uint64_t key, const void* payload)
+{
+    assert(pq != NULL);
+
+    if (pq->kind == PLIB_PQ_HEAP)
+    {
+        if (plib_pq_heap_push(pq, key, payload) == NULL)
+            return NULL;
+        pq->size++;
+        return pq;
+    }
+
+    if (key < pq->last)
+        return NULL; /* not monotone */
+
+    size_t b;
+    if (pq->kind == PLIB_PQ_RADIX)
+    {
+        b = plib_pq_radix_bucket(pq, key);
+    }
+    else
+    {
+        if (key - pq->last >= pq->num_buckets)
+            return NULL; /* beyond max_step */
+        b = (size_t)(key % pq->num_buckets);
+    }
+
+    unsigned char* r = plib_pq_vec_push(pq, &pq->buckets[b]);
+    if (r == NULL)
+        return NULL;
+    plib_pq_write(pq, r, key, payload);
+    pq->size++;
+
+    return pq;
+}
+
+PBLIB_PQ_DEF int
+plib_pq_pop(plib_pq_t* pq, uint64_t* key, void* payload)
+{
+    assert(pq != NULL);
+
+    if (pq->size == 0U)
+        return 0;
+
+    switch (pq->kind)
+    {
+        case PLIB_PQ_HEAP:
+            plib_pq_heap_pop(pq, key, payload);
+            break;
+        case PLIB_PQ_RADIX:
+            if (plib_pq_radix_pop(pq, key, payload) < 0)
+                return -1;
+            break;
+        default:
+            plib_pq_bucket_pop(pq, key, payload);
+            break;
+    }
+    pq->size--;
+
+    return 1;
+}
+
+PBLIB_PQ_DEF void
+plib_pq_clear(plib_pq_t* pq)
+{
+    if (pq == NULL)
+        return;
+
+    pq->heap.size = 0U;
+    for (size_t b = 0U; b < pq->num_buckets; b++)
+        pq->buckets[b].size = 0U;
+    pq->size = 0U;
+    pq->last = 0U;
+    pq->current = 0U;
+}
+
+PBLIB_PQ_DEF void
+plib_pq_free(plib_pq_t* pq)
+{
+    if (pq == NULL)
+        return;
+
+    free(pq->heap.data);
+    if (pq->buckets != NULL)
+    {
+        for (size_t b = 0U; b < pq->num_buckets; b++)
+            free(pq->buckets[b].data);
+    }
+    free(pq->buckets);
+    free(pq->tmp);
+    *pq = (plib_pq_t){0};
+}
+#endif /* PLIB_PQ_IMPLEMENTATION */
+
+#ifndef PLIB_PQ_NO_NAMESPACE_GUARD_
+#define PLIB_PQ_NO_NAMESPACE_GUARD_
+#ifdef PLIB_PQ_NO_NAMESPACE
+    #define pq_config_t plib_pq_config_t
+    #define pq_t plib_pq_t
+    #define pq_init plib_pq_init
+    #define pq_push plib_pq_push
+    #define pq_pop plib_pq_pop
+    #define pq_clear plib_pq_clear
+    #define pq_free plib_pq_free
+#endif /* PLIB_PQ_NO_NAMESPACE */
+#endif /* PLIB_PQ_NO_NAMESPACE_GUARD_ */
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 "piscilus" Julian Kraemer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */